@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "chroma.h"
+#include "fft.h"
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    // Pitches folded into chroma: A1 (55 Hz) to A7 (3520 Hz).
+    constexpr double LOWEST_HZ{55.};
+    constexpr double HIGHEST_HZ{3520.};
+
+    /// Pitch class of every FFT bin (-1: outside of the range).
+    vector<int8_t> const& pitch_classes() noexcept {
+        static auto const table = [] {
+            vector<int8_t> table(Chroma::FRAME / 2, -1);
+            for (size_t bin = 1; bin < table.size(); ++bin) {
+                auto const hz = double(bin) * Chroma::SAMPLE_RATE / double(Chroma::FRAME);
+                if (hz < LOWEST_HZ || hz > HIGHEST_HZ)
+                    continue;
+                auto const note = lround(12. * log2(hz / 440.)) + 69;
+                table[bin] = int8_t(note % Chroma::PITCH_CLASSES);
+            }
+            return table;
+        }();
+        return table;
+    }
+
+    vector<float> const& hann() noexcept {
+        static auto const window = [] {
+            vector<float> window(Chroma::FRAME);
+            for (size_t i = 0; i < window.size(); ++i)
+                window[i] = float(0.5 - 0.5 * cos(2. * numbers::pi * double(i) / double(window.size() - 1)));
+            return window;
+        }();
+        return window;
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          f r a m e s                             *
+ *                                                                  *
+ *******************************************************************/
+
+auto Chroma::frames(span<float const> const mono)
+-> vector<Vector> {
+    static Fft const fft{FRAME};
+    auto const& classes = pitch_classes();
+    auto const& window = hann();
+
+    vector<float> re(FRAME), im(FRAME);
+    vector<Vector> frames{};
+    if (mono.size() >= FRAME)
+        frames.reserve((mono.size() - FRAME) / HOP + 1);
+    for (size_t pos = 0; pos + FRAME <= mono.size(); pos += HOP) {
+        for (size_t i = 0; i < FRAME; ++i)
+            re[i] = mono[pos + i] * window[i];
+        std::fill(im.begin(), im.end(), 0.f);
+        fft.transform(re.data(), im.data());
+
+        Vector chroma{};
+        for (size_t bin = 1; bin < FRAME / 2; ++bin)
+            if (auto const c = classes[bin]; c >= 0)
+                chroma[c] += re[bin] * re[bin] + im[bin] * im[bin];
+        if (auto const sum = std::accumulate(chroma.begin(), chroma.end(), 0.f); sum > 0.f)
+            for (auto& value : chroma)
+                value /= sum;
+        frames.push_back(chroma);
+    }
+    return frames;
+}
@@ -0,0 +1,49 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+
+/*------- Chroma:
+-------------------------------------------------------------------*/
+/// Chroma of mono PCM (SAMPLE_RATE): every FRAME samples (hop HOP) are
+/// windowed (Hann) and go through an FFT, the power of the bins between
+/// A1 and A7 is folded into 12 pitch classes (C = 0) and normalised
+/// (the values of a frame sum to 1, silence gives zeros).
+class Chroma {
+public:
+    static constexpr int SAMPLE_RATE{11'025};
+    static constexpr size_t FRAME{4096};
+    static constexpr size_t HOP{2048};
+    static constexpr int PITCH_CLASSES{12};
+    using Vector = std::array<float, PITCH_CLASSES>;
+
+    static std::vector<Vector> frames(std::span<float const> mono);
+};
@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dsp_chain.h"
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+void DspChain::reset() noexcept {
+    for (auto const& stage : stages_)
+        stage->stage->reset();
+}
+
+void DspChain::process(vector<float>& block) noexcept {
+    using clock = chrono::steady_clock;
+    for (auto const& stage : stages_) {
+        auto const start = clock::now();
+        stage->stage->process(block);
+        auto const ns = chrono::duration_cast<chrono::nanoseconds>(clock::now() - start).count();
+        // Only the mixer thread writes, so a plain read-modify-write is enough.
+        stage->average_ns = stage->average_ns + (ns - stage->average_ns) / 16;
+        if (ns > stage->max_ns)
+            stage->max_ns = ns;
+    }
+}
+
+size_t DspChain::max_frames(size_t frames) const noexcept {
+    for (auto const& stage : stages_)
+        frames = stage->stage->max_frames(frames);
+    return frames;
+}
+
+auto DspChain::costs() const
+-> vector<Cost> {
+    vector<Cost> costs{};
+    costs.reserve(stages_.size());
+    for (auto const& stage : stages_)
+        costs.push_back({stage->stage->name(), stage->average_ns.load(), stage->max_ns.load()});
+    return costs;
+}
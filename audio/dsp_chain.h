@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <string>
+
+/*------- DspStage:
+-------------------------------------------------------------------*/
+/// One stage of the DspChain. Works on interleaved float blocks
+/// (Track::CHANNELS channels) in place; a stage may change the number
+/// of frames (the resampler). Called only from the mixer thread,
+/// must not block or allocate once it has seen the first blocks.
+class DspStage {
+public:
+    virtual ~DspStage() = default;
+    virtual char const* name() const noexcept = 0;
+    /// Forget the history (after a seek the old samples mustn't be heard).
+    virtual void reset() noexcept = 0;
+    virtual void process(std::vector<float>& block) noexcept = 0;
+    /// Upper bound of output frames for the input frames.
+    virtual size_t max_frames(size_t const frames) const noexcept {
+        return frames;
+    }
+};
+
+/*------- DspChain:
+-------------------------------------------------------------------*/
+/// Stages between the mixer and the output, one after another.
+/// The time every stage takes is measured per block; the costs can be
+/// read from any thread.
+class DspChain {
+public:
+    struct Cost {
+        std::string stage{};
+        int64_t average_ns{};   // exponential average over the last blocks
+        int64_t max_ns{};
+    };
+private:
+    struct Stage {
+        std::unique_ptr<DspStage> stage;
+        std::atomic<int64_t> average_ns{};
+        std::atomic<int64_t> max_ns{};
+    };
+    std::vector<std::unique_ptr<Stage>> stages_{};
+public:
+    /// Stages are added before the first block; returns the stage.
+    template<typename T>
+    T* add(std::unique_ptr<T> stage) {
+        auto const ptr = stage.get();
+        stages_.push_back(std::make_unique<Stage>(std::move(stage)));
+        return ptr;
+    }
+    void reset() noexcept;
+    void process(std::vector<float>& block) noexcept;
+    size_t max_frames(size_t frames) const noexcept;
+    std::vector<Cost> costs() const;
+};
@@ -0,0 +1,489 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "engine.h"
+#include "limiter.h"
+#include "resampler.h"
+#include <QTimer>
+#include <QIODevice>
+#include <QAudioSink>
+#include <QAudioDevice>
+#include <QMediaDevices>
+#include <chrono>
+using namespace std;
+
+namespace {
+    // The incoming song goes up from 'gain', the outgoing one goes down.
+    // No branches in the loop, so the compiler vectorizes it.
+    void ramp(float* const incoming, float const* const outgoing, size_t const frames,
+              float const gain, float const step) noexcept
+    {
+        for (size_t i = 0; i < frames * Track::CHANNELS; ++i) {
+            auto const g = std::min(1.f, gain + step * float(i / Track::CHANNELS));
+            incoming[i] = outgoing[i] + (incoming[i] - outgoing[i]) * g;
+        }
+    }
+
+    int64_t now_us() noexcept {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+/*------- Engine::Output ::QObject:
+-------------------------------------------------------------------*/
+/// Lives in the audio thread. Every period moves from the ring to the sink
+/// as much as the sink takes. Pause, volume and flush (seek) are applied here,
+/// so they are heard as soon as possible. No locks, no allocations.
+class Engine::Output : public QObject {
+    static constexpr size_t FRAME_BYTES{Track::CHANNELS * sizeof(float)};
+    Engine* const engine_;
+    QAudioSink* sink_{};
+    QIODevice* device_{};
+    QTimer* timer_{};
+    std::vector<float> buffer_{};
+    uint generation_{};
+    float gain_{1.f};
+    bool suspended_{};
+public:
+    explicit Output(Engine* const engine) : engine_{engine} {}
+
+    void start() noexcept {
+        auto const& config = engine_->config_;
+        sink_ = new QAudioSink(engine_->output_format(), this);
+        sink_->setBufferSize(qsizetype(ms_to_samples(config.sink_ms, engine_->output_rate_) * sizeof(float)));
+        connect(sink_, &QAudioSink::stateChanged, this, [this] (QAudio::State const state) {
+            if (state == QAudio::IdleState && sink_->error() == QAudio::UnderrunError)
+                ++engine_->underruns_;
+        });
+        device_ = sink_->start();
+        // The sink may have chosen its own size.
+        buffer_.resize(std::max(size_t(sink_->bufferSize()) / sizeof(float), ms_to_samples(config.sink_ms, engine_->output_rate_)));
+
+        timer_ = new QTimer(this);
+        timer_->setTimerType(Qt::PreciseTimer);
+        connect(timer_, &QTimer::timeout, this, &Output::feed);
+        timer_->start(config.period_ms);
+    }
+    void stop() noexcept {
+        if (timer_)
+            timer_->stop();
+        if (sink_)
+            sink_->stop();
+    }
+private:
+    void feed() noexcept;
+};
+
+void Engine::Output::feed() noexcept {
+    auto& engine = *engine_;
+    auto applied = false;
+
+    // After play/seek what is in the ring belongs to the old song/position.
+    // The mixer publishes where the new samples begin before it writes them,
+    // so everything written before we look there is old, unless it says otherwise.
+    if (auto const generation = engine.generation_.load(); generation != generation_) {
+        auto const written = engine.ring_.written();
+        auto const start = engine.generation_start_.load();
+        if (start >> 48 == (generation & 0xFFFF)) {
+            engine.ring_.discard(size_t(start & 0xFFFF'FFFF'FFFF));
+            generation_ = generation;
+            applied = true;
+        }
+        else
+            engine.ring_.discard(written);
+    }
+    if (auto const paused = engine.paused_.load(); paused != suspended_) {
+        paused ? sink_->suspend() : sink_->resume();
+        suspended_ = paused;
+        applied = true;
+    }
+    if (auto const gain = engine.muted_ ? 0.f : engine.volume_.load(); gain != gain_) {
+        gain_ = gain;
+        applied = true;
+    }
+
+    if (!suspended_) {
+        auto wanted = std::min(size_t(sink_->bytesFree()) / sizeof(float), buffer_.size());
+        wanted -= wanted % Track::CHANNELS;
+        if (auto const n = engine.ring_.read(buffer_.data(), wanted)) {
+            if (gain_ != 1.f)
+                for (size_t i = 0; i < n; ++i)
+                    buffer_[i] *= gain_;
+            device_->write(reinterpret_cast<char const*>(buffer_.data()), qint64(n * sizeof(float)));
+        }
+    }
+
+    auto const sink_frames = qint64(sink_->bufferSize() - sink_->bytesFree()) / qint64(FRAME_BYTES);
+    engine.sink_frames_ = sink_frames;
+    if (applied) {
+        // The new state is heard when the sink plays out what it already has
+        // (a suspended sink is silent at once).
+        auto const ms = (now_us() - engine.command_at_) / 1000 + (suspended_ ? 0 : frames_to_ms(sink_frames, engine.output_rate_));
+        engine.command_ms_ = ms;
+        if (ms > engine.max_command_ms_)
+            engine.max_command_ms_ = ms;
+    }
+}
+
+Engine::Engine(QObject* const parent, Config const& config) :
+    QObject{parent},
+    config_{config},
+    output_rate_{output_rate(config)},
+    ring_{ms_to_samples(config.ring_ms, output_rate_)},
+    cache_{Track::CHANNELS, size_t(config.cache_mb) << 20, config.cache_compact},
+    output_{new Output(this)},
+    timer_{new QTimer(this)},
+    seek_timer_{new QTimer(this)},
+    scratch_(ms_to_samples(config.period_ms))
+{
+    retired_.reserve(8);
+    equalizer_ = dsp_.add(make_unique<Equalizer>(Track::SAMPLE_RATE));
+    dsp_.add(make_unique<Limiter>(Track::SAMPLE_RATE));
+    if (output_rate_ != Track::SAMPLE_RATE)
+        dsp_.add(make_unique<Resampler>(Track::SAMPLE_RATE, output_rate_));
+    // The chain is complete, the mixer may start.
+    mixer_ = jthread{[this] (stop_token const& token) { run(token); }};
+    command();
+    decoder_thread_.start();
+
+    output_->moveToThread(&audio_thread_);
+    connect(&audio_thread_, &QThread::finished, output_, &QObject::deleteLater);
+    audio_thread_.start(QThread::TimeCriticalPriority);
+    QMetaObject::invokeMethod(output_, &Output::start);
+
+    connect(timer_, &QTimer::timeout, this, &Engine::report);
+    timer_->start(TIMER_INTERVAL_MS);
+
+    seek_timer_->setSingleShot(true);
+    seek_timer_->setInterval(SEEK_COALESCE_MS);
+    connect(seek_timer_, &QTimer::timeout, this, &Engine::seek_now);
+}
+
+Engine::~Engine() {
+    timer_->stop();
+    mixer_.request_stop();
+    mixer_.join();
+    QMetaObject::invokeMethod(output_, &Output::stop, Qt::BlockingQueuedConnection);
+    audio_thread_.quit();
+    audio_thread_.wait();
+
+    {
+        lock_guard<mutex> lg{mutex_};
+        retire(fading_);
+        retire(current_);
+        retire(next_);
+        retired_.clear();
+    }
+    decoder_thread_.quit();
+    decoder_thread_.wait();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           o p e n                                *
+ *                                                                  *
+ *******************************************************************/
+
+auto Engine::open(QString const& path, float const gain, qint64 const start_ms) noexcept
+-> TrackPtr {
+    // What was decoded before is read from memory, the decoder goes on where it ends.
+    auto const start_frame = start_ms * Track::SAMPLE_RATE / 1000;
+    auto lease = cache_.lease(path, start_frame);
+
+    // With the index the decoder starts near that point, not at the beginning.
+    // Its samples continue the kept ones exactly only when it decodes from
+    // the beginning of the file (an entry is approximate, MP3 loses samples
+    // after a jump), so that is preferred while the kept samples last longer
+    // than decoding up to their end takes.
+    optional<SeekIndex::Point> entry{};
+    if (lease.end_frame > 0 && !lease.complete) {
+        auto const kept = lease.end_frame - start_frame;
+        if (!lease.writer || kept * MIN_DECODE_SPEED < lease.end_frame)
+            if (auto const index = SeekIndex::for_path(path.toStdString()))
+                entry = index->find(lease.end_frame * 1000 / Track::SAMPLE_RATE);
+    }
+
+    auto const track = new Track(path, gain, start_ms, entry, std::move(lease));
+    track->moveToThread(&decoder_thread_);
+    QMetaObject::invokeMethod(track, &Track::start);
+    // The track must die in its own thread.
+    return {track, [] (Track* const track) { track->deleteLater(); }};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                 p l a y   /   e n q u e u e                      *
+ *                                                                  *
+ *******************************************************************/
+
+void Engine::play(QString const& path, float const gain) noexcept {
+    {
+        lock_guard<mutex> lg{mutex_};
+        retire(fading_);
+        retire(current_);
+        if (next_ && next_->path() == path && next_->gain() == gain)
+            current_ = std::move(next_);    // is already being decoded
+        else {
+            retire(next_);
+            current_ = open(path, gain);
+        }
+        ++generation_;
+    }
+    reported_duration_ = -1;
+    finished_ = false;
+    paused_ = false;
+    command();
+}
+
+void Engine::enqueue(QString const& path, float const gain) noexcept {
+    lock_guard<mutex> lg{mutex_};
+    if (next_ && next_->path() == path && next_->gain() == gain)
+        return;
+    retire(next_);
+    next_ = open(path, gain);
+}
+
+void Engine::set_gain(QString const& path, float const gain) noexcept {
+    lock_guard<mutex> lg{mutex_};
+    for (auto const& track : {current_, next_})
+        if (track && track->path() == path)
+            track->set_gain(gain);
+}
+
+QString Engine::enqueued() noexcept {
+    lock_guard<mutex> lg{mutex_};
+    return next_ ? next_->path() : QString{};
+}
+
+void Engine::seek(qint64 const position_ms) noexcept {
+    {
+        lock_guard<mutex> lg{mutex_};
+        seek_path_ = current_ ? current_->path() : QString{};
+    }
+    seek_target_ = position_ms;
+    seek_at_ = now_us();
+    if (!seek_timer_->isActive())
+        seek_timer_->start();
+}
+
+void Engine::seek_now() noexcept {
+    {
+        lock_guard<mutex> lg{mutex_};
+        // The song could have changed while the seek was waiting.
+        if (!current_ || current_->path() != seek_path_)
+            return;
+        auto const path = current_->path();
+        auto const duration = current_->duration_ms();
+        auto const gain = current_->gain();
+
+        retire(fading_);
+        retire(current_);
+        current_ = open(path, gain, seek_target_);
+        current_->set_duration(duration);
+        seeking_ = true;
+        ++generation_;
+    }
+    command();
+}
+
+void Engine::command() noexcept {
+    command_at_ = now_us();
+}
+
+auto Engine::stats() const noexcept
+-> Stats {
+    auto const buffered = qint64(ring_.size() / Track::CHANNELS) + sink_frames_;
+    return {underruns_, frames_to_ms(buffered, output_rate_), command_ms_, max_command_ms_, seek_ms_, dsp_.costs(), cache_.bytes()};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                   o u t p u t _ f o r m a t                      *
+ *                                                                  *
+ *******************************************************************/
+
+/// The songs' format at the output rate.
+QAudioFormat Engine::output_format() const noexcept {
+    auto format = Track::format();
+    format.setSampleRate(output_rate_);
+    return format;
+}
+
+/// Playing at the rate the device runs at, we resample ourselves
+/// (instead of the sound server), with a known quality.
+int Engine::output_rate(Config const& config) noexcept {
+    if (config.output_rate > 0)
+        return config.output_rate;
+    if (auto const device = QMediaDevices::defaultAudioOutput(); !device.isNull())
+        if (auto const rate = device.preferredFormat().sampleRate(); rate >= 8'000 && rate <= 384'000)
+            return rate;
+    return Track::SAMPLE_RATE;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            r u n                                 *
+ *                                                                  *
+ *******************************************************************/
+
+void Engine::run(stop_token const& token) noexcept {
+    vector<float> block(ms_to_samples(config_.period_ms));
+    auto const frames = block.size() / Track::CHANNELS;
+    auto const nap = chrono::milliseconds(std::max(1, config_.period_ms / 2));
+    // What a block can become after the chain (resampled).
+    auto const capacity = dsp_.max_frames(frames) * Track::CHANNELS;
+    block.reserve(capacity);
+    uint generation{};
+
+    // Keeps the ring full; when it is full (or the sink is paused) we wait.
+    while (!token.stop_requested()) {
+        if (ring_.free() < capacity) {
+            this_thread::sleep_for(nap);
+            continue;
+        }
+        block.resize(frames * Track::CHANNELS);
+        auto const mixed = mix(block.data(), frames);
+        auto const fresh = mixed != generation;
+        {
+            lock_guard<mutex> lg{dsp_mutex_};
+            // A new song/position: the chain forgets the old one.
+            if (fresh)
+                dsp_.reset();
+            dsp_.process(block);
+        }
+        if (fresh) {
+            generation = mixed;
+            generation_start_ = generation_start(generation, ring_.written());
+        }
+        ring_.write(block.data(), block.size());
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            m i x                                 *
+ *                                                                  *
+ *******************************************************************/
+
+/// Returns the generation of the mixed samples.
+uint Engine::mix(float* const out, size_t const frames) noexcept {
+    auto const samples = frames * Track::CHANNELS;
+    std::fill_n(out, samples, 0.f);
+
+    lock_guard<mutex> lg{mutex_};
+    auto const generation = generation_.load();
+    if (scratch_.size() < samples)
+        scratch_.resize(samples);
+
+    // The current song is about to end, the crossfade begins.
+    if (current_ && next_ && !fading_) {
+        auto const fade = crossfade_ms_ * Track::SAMPLE_RATE / 1000;
+        if (auto const remaining = current_->remaining_frames(); fade > 0 && remaining && *remaining <= fade) {
+            fade_frames_ = std::max<qint64>(1, *remaining);
+            fade_position_ = 0;
+            fading_ = std::move(current_);
+            current_ = std::move(next_);
+            ++started_;
+        }
+    }
+
+    if (current_) {
+        auto done = current_->read(out, frames);
+        if (seeking_ && done) {
+            // The first samples after the seek will be heard after what waits before them.
+            auto const buffered = qint64(ring_.size() / Track::CHANNELS) + sink_frames_;
+            seek_ms_ = (now_us() - seek_at_) / 1000 + frames_to_ms(buffered, output_rate_);
+            seeking_ = false;
+        }
+        // Gapless: the next song starts right at the next sample.
+        while (done < frames && current_->drained()) {
+            retire(current_);
+            if (!next_) {
+                finished_ = true;
+                break;
+            }
+            current_ = std::move(next_);
+            ++started_;
+            done += current_->read(out + done * Track::CHANNELS, frames - done);
+        }
+    }
+
+    if (fading_) {
+        auto const n = fading_->read(scratch_.data(), frames);
+        auto const step = 1.f / float(fade_frames_);
+        ramp(out, scratch_.data(), n, float(fade_position_) * step, step);
+        fade_position_ += qint64(n);
+        if (fade_position_ >= fade_frames_ || fading_->drained())
+            retire(fading_);
+    }
+    return generation;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          r e p o r t                             *
+ *                                                                  *
+ *******************************************************************/
+
+void Engine::report() noexcept {
+    QString started{};
+    qint64 position{-1};
+    qint64 duration{-1};
+    vector<pair<QString, Waveform>> waveforms{};
+    {
+        lock_guard<mutex> lg{mutex_};
+        retired_.clear();
+        for (auto const& track : {current_, next_})
+            if (track)
+                if (auto waveform = track->take_waveform())
+                    waveforms.emplace_back(track->path(), std::move(*waveform));
+        if (current_) {
+            // The mixer is ahead of what we hear by what waits in the buffers.
+            position = std::max<qint64>(0, current_->position_ms() - stats().buffered_ms);
+            duration = current_->duration_ms();
+        }
+        if (auto const n = started_.load(); n != reported_started_) {
+            reported_started_ = n;
+            if (current_)
+                started = current_->path();
+        }
+    }
+
+    if (!started.isEmpty()) {
+        reported_duration_ = -1;
+        emit track_started(started);
+    }
+    if (duration >= 0 && duration != reported_duration_)
+        emit duration_changed(reported_duration_ = duration);
+    if (position >= 0 && position != reported_position_)
+        emit position_changed(reported_position_ = position);
+    if (finished_.exchange(false))
+        emit finished();
+    for (auto const& [path, waveform] : waveforms)
+        emit waveform_ready(path, waveform);
+}
@@ -0,0 +1,228 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "track.h"
+#include "ring_buffer.hh"
+#include "dsp_chain.h"
+#include "equalizer.h"
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+/*------- forward declarations:
+-------------------------------------------------------------------*/
+class QTimer;
+
+/*------- Engine ::QObject:
+-------------------------------------------------------------------*/
+/// Playback: tracks are decoded in the decoder thread and mixed in the mixer
+/// thread; the mixed blocks go through the DSP chain (equalizer, limiter and,
+/// when the device runs at another rate, resampler) into a lock-free ring.
+/// The audio thread moves the samples from
+/// the ring to the audio sink (push mode), applying volume on the way;
+/// it never locks, allocates or waits. Reports go out from the GUI thread.
+/// Decoded songs stay in the PcmCache: played again or scrubbed back,
+/// they are read from memory instead of being decoded again.
+/// The song given with enqueue() follows the current one: right at the
+/// sample where the current one ends (gapless), or overlapping with it
+/// by the crossfade time.
+/// The mixer doesn't signal anything itself, it only marks what happened;
+/// the GUI thread looks at the marks every TIMER_INTERVAL_MS.
+class Engine : public QObject {
+    Q_OBJECT
+    class Output;
+    using TrackPtr = std::shared_ptr<Track>;
+    static int const TIMER_INTERVAL_MS{100};
+    // Seeks requested within this time (dragging the slider) become one seek.
+    static int const SEEK_COALESCE_MS{40};
+    // How much faster than real time (at least) a song is decoded.
+    static int const MIN_DECODE_SPEED{20};
+public:
+    static qint64 const MAX_CROSSFADE_MS{10'000};
+
+    /// Buffer sizes. A pause, seek or volume change is heard after
+    /// at most ring_ms + sink_ms (plus one period).
+    struct Config {
+        int ring_ms{200};       // mixed samples waiting for the sink
+        int sink_ms{60};        // the sink's own buffer
+        int period_ms{10};      // mixing block and the feeding interval
+        int output_rate{};      // sample rate of the sink, 0: what the device prefers
+        int cache_mb{384};      // decoded songs kept in memory
+        bool cache_compact{};   // kept as 16-bit samples (see PcmCache)
+    };
+    struct Stats {
+        uint64_t underruns{};
+        qint64 buffered_ms{};       // in the ring and in the sink right now
+        qint64 command_ms{};        // last pause/seek/volume: from the request to the speaker
+        qint64 max_command_ms{};
+        qint64 seek_ms{};           // last seek: from the request to the speaker
+        std::vector<DspChain::Cost> dsp{};  // per mixing block (period_ms)
+        size_t cache_bytes{};       // decoded songs in memory
+    };
+private:
+    Config const config_;
+    int const output_rate_;             // the ring and the sink run at this rate
+    RingBuffer<float> ring_;
+    PcmCache cache_;                    // outlives the tracks (and their writers)
+    QThread decoder_thread_{};
+    QThread audio_thread_{};
+    Output* const output_;
+    QTimer* const timer_;
+    QTimer* const seek_timer_;
+    qint64 seek_target_{};
+    QString seek_path_{};              // the song the seek was asked for
+
+    std::mutex mutex_{};                // guards the tracks and the fade
+    TrackPtr current_{};
+    TrackPtr next_{};
+    TrackPtr fading_{};                 // the previous song during a crossfade
+    qint64 fade_frames_{};
+    qint64 fade_position_{};
+    bool seeking_{};                    // waiting for the first samples after a seek
+    std::vector<float> scratch_{};
+    std::vector<TrackPtr> retired_{};   // released in the GUI thread
+
+    std::mutex dsp_mutex_{};            // guards the chain (settings come from the GUI thread)
+    DspChain dsp_{};
+    Equalizer* equalizer_{};
+
+    std::atomic<qint64> crossfade_ms_{};
+    std::atomic<float> volume_{1.f};
+    std::atomic<bool> muted_{};
+    std::atomic<bool> paused_{true};
+    // play() and seek start a new generation (under mutex_); the audio thread
+    // drops the samples of the older ones. The mixer tells where in the ring
+    // the samples of its generation begin: generation (16 bits) | position.
+    std::atomic<uint> generation_{};
+    std::atomic<uint64_t> generation_start_{};
+    std::atomic<uint> started_{};       // number of handovers to the enqueued song
+    std::atomic<bool> finished_{};
+
+    // Measurements, written by the audio thread.
+    std::atomic<int64_t> command_at_{};     // when the last command was given (steady clock, µs)
+    std::atomic<qint64> command_ms_{};
+    std::atomic<qint64> max_command_ms_{};
+    std::atomic<uint64_t> underruns_{};
+    std::atomic<qint64> sink_frames_{};     // frames in the sink's buffer
+    std::atomic<int64_t> seek_at_{};
+    std::atomic<qint64> seek_ms_{};
+
+    // What was already reported.
+    uint reported_started_{};
+    qint64 reported_position_{-1};
+    qint64 reported_duration_{-1};
+
+    std::jthread mixer_;
+public:
+    Engine(QObject* parent, Config const& config);
+    ~Engine();
+
+    /// Starts the song right now (the current one is cut off).
+    /// The gain (ReplayGain) is applied to the song's samples.
+    void play(QString const& path, float gain = 1.f) noexcept;
+    /// The song to be played after the current one.
+    void enqueue(QString const& path, float gain = 1.f) noexcept;
+    QString enqueued() noexcept;
+    /// The song's gain became known while it is played (or enqueued).
+    void set_gain(QString const& path, float gain) noexcept;
+    /// Seeks come in bursts; only the last one of a burst is done.
+    void seek(qint64 position_ms) noexcept;
+
+    void set_paused(bool const paused) noexcept {
+        if (paused_.exchange(paused) != paused)
+            command();
+    }
+    void set_volume(float const volume) noexcept {
+        if (volume_.exchange(volume) != volume)
+            command();
+    }
+    void set_muted(bool const muted) noexcept {
+        if (muted_.exchange(muted) != muted)
+            command();
+    }
+    void set_crossfade(qint64 const ms) noexcept {
+        crossfade_ms_ = std::clamp<qint64>(ms, 0, MAX_CROSSFADE_MS);
+    }
+    /// Gains of the equalizer bands (dB), heard after the ring.
+    void set_equalizer(Equalizer::Gains const& gains) noexcept {
+        std::lock_guard<std::mutex> lg{dsp_mutex_};
+        equalizer_->set_gains(gains);
+    }
+    /// Frequency, Q and gain of one band of the equalizer.
+    void set_equalizer_band(size_t const index, Equalizer::Band const& band) noexcept {
+        std::lock_guard<std::mutex> lg{dsp_mutex_};
+        equalizer_->set_band(index, band);
+    }
+    qint64 crossfade() const noexcept {
+        return crossfade_ms_;
+    }
+    Stats stats() const noexcept;
+
+signals:
+    void position_changed(qint64 position_ms);
+    void duration_changed(qint64 duration_ms);
+    /// The enqueued song has become the current one.
+    void track_started(QString const& path);
+    /// There is nothing more to play.
+    void finished();
+    /// A song was decoded whole, its overview is ready.
+    void waveform_ready(QString const& path, Waveform const& waveform);
+
+private:
+    TrackPtr open(QString const& path, float gain, qint64 start_ms = 0) noexcept;
+    void seek_now() noexcept;
+    void run(std::stop_token const& token) noexcept;
+    uint mix(float* out, size_t frames) noexcept;
+    void report() noexcept;
+    void command() noexcept;
+    // mutex_ must be locked.
+    void retire(TrackPtr& track) noexcept {
+        if (track)
+            retired_.push_back(std::move(track));
+        track.reset();
+    }
+    QAudioFormat output_format() const noexcept;
+    static uint64_t generation_start(uint const generation, size_t const position) noexcept {
+        return uint64_t(generation & 0xFFFF) << 48 | (position & 0xFFFF'FFFF'FFFF);
+    }
+    static int output_rate(Config const& config) noexcept;
+    static qint64 frames_to_ms(qint64 const frames, int const rate = Track::SAMPLE_RATE) noexcept {
+        return frames * 1000 / rate;
+    }
+    static size_t ms_to_samples(int const ms, int const rate = Track::SAMPLE_RATE) noexcept {
+        return size_t(ms) * size_t(rate) / 1000 * Track::CHANNELS;
+    }
+};
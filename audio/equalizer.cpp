@@ -0,0 +1,106 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "equalizer.h"
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+using namespace std;
+
+Equalizer::Equalizer(int const sample_rate) :
+    sample_rate_{sample_rate}
+{
+    for (size_t i = 0; i < BANDS; ++i)
+        bands_[i].frequency = FREQUENCIES[i];
+}
+
+void Equalizer::reset() noexcept {
+    for (auto& filter : filters_) {
+        filter.z1.fill(0.f);
+        filter.z2.fill(0.f);
+    }
+}
+
+void Equalizer::set_gains(Gains const& gains) noexcept {
+    for (size_t i = 0; i < BANDS; ++i) {
+        bands_[i].gain = std::clamp(gains[i], -MAX_GAIN_DB, MAX_GAIN_DB);
+        update(i);
+    }
+}
+
+void Equalizer::set_band(size_t const index, Band const& band) noexcept {
+    if (index >= BANDS)
+        return;
+    bands_[index] = {
+        .frequency = std::clamp(band.frequency, MIN_FREQUENCY, 0.5f * float(sample_rate_)),
+        .q = std::clamp(band.q, MIN_Q, MAX_Q),
+        .gain = std::clamp(band.gain, -MAX_GAIN_DB, MAX_GAIN_DB)
+    };
+    update(index);
+}
+
+/// Peaking filter of the band.
+void Equalizer::update(size_t const index) noexcept {
+    auto const& band = bands_[index];
+    auto& filter = filters_[index];
+    // A band near (or above) Nyquist can't be made (and isn't heard anyway).
+    filter.active = band.gain != 0.f && band.frequency < 0.45f * float(sample_rate_);
+    if (!filter.active)
+        return;
+
+    auto const a = pow(10., double(band.gain) / 40.);
+    auto const w0 = 2. * numbers::pi * double(band.frequency) / double(sample_rate_);
+    auto const alpha = sin(w0) / (2. * double(band.q));
+    auto const a0 = 1. + alpha / a;
+    filter.b0 = float((1. + alpha * a) / a0);
+    filter.b1 = float(-2. * cos(w0) / a0);
+    filter.b2 = float((1. - alpha * a) / a0);
+    filter.a1 = filter.b1;
+    filter.a2 = float((1. - alpha / a) / a0);
+}
+
+void Equalizer::process(vector<float>& block) noexcept {
+    auto const frames = block.size() / CHANNELS;
+    for (auto& filter : filters_) {
+        if (!filter.active)
+            continue;
+        auto const b0 = filter.b0, b1 = filter.b1, b2 = filter.b2, a1 = filter.a1, a2 = filter.a2;
+        auto z1 = filter.z1;
+        auto z2 = filter.z2;
+        auto data = block.data();
+        for (size_t i = 0; i < frames; ++i, data += CHANNELS)
+            for (int c = 0; c < CHANNELS; ++c) {
+                auto const x = data[c];
+                auto const y = b0 * x + z1[c];
+                z1[c] = b1 * x - a1 * y + z2[c];
+                z2[c] = b2 * x - a2 * y;
+                data[c] = y;
+            }
+        filter.z1 = z1;
+        filter.z2 = z2;
+    }
+}
@@ -0,0 +1,87 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dsp_chain.h"
+#include <array>
+#include <numbers>
+
+/*------- Equalizer ::DspStage:
+-------------------------------------------------------------------*/
+/// Ten band equalizer: peaking biquads (RBJ cookbook) in cascade. By default
+/// the bands are one octave wide at the ISO centres 31 Hz ... 16 kHz (graphic
+/// equalizer, set by gains only); every band's frequency and Q can be moved
+/// (parametric equalizer). Bands set to 0 dB are skipped, so the flat
+/// equalizer costs nothing.
+/// The recursion of a biquad goes sample by sample; what runs side by side
+/// are the channels of a frame.
+class Equalizer : public DspStage {
+public:
+    static constexpr size_t BANDS{10};
+    static constexpr std::array<float, BANDS> FREQUENCIES{31.25f, 62.5f, 125.f, 250.f, 500.f, 1000.f, 2000.f, 4000.f, 8000.f, 16000.f};
+    static constexpr float OCTAVE_Q{std::numbers::sqrt2_v<float>};  // bandwidth of one octave
+    static constexpr float MIN_FREQUENCY{20.f};
+    static constexpr float MIN_Q{0.1f};
+    static constexpr float MAX_Q{20.f};
+    static constexpr float MAX_GAIN_DB{12.f};
+    using Gains = std::array<float, BANDS>;     // dB
+    struct Band {
+        float frequency{};  // Hz
+        float q{OCTAVE_Q};
+        float gain{};       // dB
+    };
+private:
+    static constexpr int CHANNELS{2};
+    // Normalised coefficients (a0 = 1) and the state of every channel (transposed direct form II).
+    struct Filter {
+        float b0{1.f}, b1{}, b2{}, a1{}, a2{};
+        std::array<float, CHANNELS> z1{}, z2{};
+        bool active{};
+    };
+    int const sample_rate_;
+    std::array<Band, BANDS> bands_{};
+    std::array<Filter, BANDS> filters_{};
+public:
+    explicit Equalizer(int sample_rate);
+
+    char const* name() const noexcept override {
+        return "equalizer";
+    }
+    void reset() noexcept override;
+    void process(std::vector<float>& block) noexcept override;
+
+    /// New gains (clamped to +-MAX_GAIN_DB), frequencies and Qs of the bands
+    /// stay. The state of the filters stays, so the change doesn't click.
+    void set_gains(Gains const& gains) noexcept;
+    /// New frequency, Q and gain of the band (clamped to what can be made).
+    void set_band(size_t index, Band const& band) noexcept;
+    Band const& band(size_t const index) const noexcept {
+        return bands_[index];
+    }
+private:
+    void update(size_t index) noexcept;
+};
@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "fft.h"
+#include <cmath>
+#include <bit>
+#include <numbers>
+#include <utility>
+using namespace std;
+
+namespace {
+    /// One group of butterflies: a[j], b[j] <- a[j] + w[j] b[j], a[j] - w[j] b[j].
+    void butterflies(float* __restrict const ar, float* __restrict const ai,
+                     float* __restrict const br, float* __restrict const bi,
+                     float const* __restrict const wr, float const* __restrict const wi,
+                     size_t const n) noexcept
+    {
+        for (size_t j = 0; j < n; ++j) {
+            auto const tr = br[j] * wr[j] - bi[j] * wi[j];
+            auto const ti = br[j] * wi[j] + bi[j] * wr[j];
+            br[j] = ar[j] - tr;
+            bi[j] = ai[j] - ti;
+            ar[j] += tr;
+            ai[j] += ti;
+        }
+    }
+}
+
+Fft::Fft(size_t const size) :
+    size_{std::bit_ceil(std::max<size_t>(2, size))},
+    reversed_(size_),
+    twiddle_re_(size_ - 1),
+    twiddle_im_(size_ - 1)
+{
+    auto const bits = std::countr_zero(size_);
+    for (size_t i = 0; i < size_; ++i) {
+        uint32_t r{};
+        for (int b = 0; b < bits; ++b)
+            r |= uint32_t((i >> b) & 1) << (bits - 1 - b);
+        reversed_[i] = r;
+    }
+    for (size_t h = 1; h < size_; h *= 2)
+        for (size_t j = 0; j < h; ++j) {
+            auto const angle = -std::numbers::pi * double(j) / double(h);
+            twiddle_re_[h - 1 + j] = float(cos(angle));
+            twiddle_im_[h - 1 + j] = float(sin(angle));
+        }
+}
+
+void Fft::transform(float* const re, float* const im) const noexcept {
+    for (size_t i = 0; i < size_; ++i)
+        if (auto const r = reversed_[i]; i < r) {
+            std::swap(re[i], re[r]);
+            std::swap(im[i], im[r]);
+        }
+
+    for (size_t h = 1; h < size_; h *= 2)
+        for (size_t k = 0; k < size_; k += 2 * h)
+            butterflies(re + k, im + k, re + k + h, im + k + h, &twiddle_re_[h - 1], &twiddle_im_[h - 1], h);
+}
@@ -0,0 +1,53 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*------- Fft:
+-------------------------------------------------------------------*/
+/// In-place radix-2 FFT of complex data in split form (real and imaginary
+/// parts in separate arrays). Twiddle factors of every stage are stored
+/// one after another, so the butterflies of a stage read and write only
+/// contiguous memory and the compiler vectorizes them.
+class Fft {
+    size_t const size_;
+    std::vector<uint32_t> reversed_{};      // bit-reversed index of every index
+    // Stage with butterflies of half-size h uses factors [h - 1, 2h - 1).
+    std::vector<float> twiddle_re_{};
+    std::vector<float> twiddle_im_{};
+public:
+    /// The size must be a power of two.
+    explicit Fft(size_t size);
+
+    size_t size() const noexcept {
+        return size_;
+    }
+    void transform(float* re, float* im) const noexcept;
+};
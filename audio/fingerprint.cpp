@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "fingerprint.h"
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    constexpr float SILENCE{1e-3f};
+    // Chroma values closer than this count as equal (bit 0), otherwise
+    // the comparisons between nearly empty classes would be noise.
+    constexpr float MARGIN{0.02f};
+    // Bits compared between pitch classes (not in time) are the stable ones,
+    // only they go into the MinHash.
+    constexpr uint32_t STABLE_BITS{0xFF00'0FFF};
+    constexpr int PITCH_CLASSES{Chroma::PITCH_CLASSES};
+
+    uint64_t mix(uint64_t x) noexcept {
+        // splitmix64 finalizer
+        x ^= x >> 30;
+        x *= 0xBF58'476D'1CE4'E5B9;
+        x ^= x >> 27;
+        x *= 0x94D0'49BB'1331'11EB;
+        return x ^ (x >> 31);
+    }
+
+    /// 32 bits from the chroma and the previous one:
+    ///   0-11  class i louder than class i + 1,
+    ///   12-23 class i louder than in the previous frame,
+    ///   24-31 class i louder than class i + 4 (a third above).
+    uint32_t code(Chroma::Vector const& c, Chroma::Vector const& previous) noexcept {
+        uint32_t code{};
+        for (int i = 0; i < PITCH_CLASSES; ++i) {
+            code |= uint32_t(c[i] > c[(i + 1) % PITCH_CLASSES] + MARGIN) << i;
+            code |= uint32_t(c[i] > previous[i] + MARGIN) << (12 + i);
+        }
+        for (int i = 0; i < 8; ++i)
+            code |= uint32_t(c[i] > c[(i + 4) % PITCH_CLASSES] + MARGIN) << (24 + i);
+        return code;
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                         B u i l d e r                            *
+ *                                                                  *
+ *******************************************************************/
+
+Fingerprint::Builder::Builder() {
+    mono_.reserve(size_t(WINDOW_SECONDS) * SAMPLE_RATE);
+}
+
+/// Mono, without the silence at the beginning, every DECIMATION samples
+/// averaged into one (a crude, but for chroma sufficient, low pass).
+void Fingerprint::Builder::add(float const* const samples, size_t const frames) noexcept {
+    for (size_t i = 0; i < frames && !complete(); ++i) {
+        float sum{};
+        for (int c = 0; c < INPUT_CHANNELS; ++c)
+            sum += samples[i * INPUT_CHANNELS + c];
+        auto const mono = sum / float(INPUT_CHANNELS);
+        if (!sound_ && std::abs(mono) < SILENCE)
+            continue;
+        sound_ = true;
+        pending_[pending_count_++] = mono;
+        if (pending_count_ == DECIMATION) {
+            mono_.push_back((pending_[0] + pending_[1] + pending_[2] + pending_[3]) / float(DECIMATION));
+            pending_count_ = 0;
+        }
+    }
+}
+
+bool Fingerprint::Builder::complete() const noexcept {
+    return mono_.size() >= size_t(WINDOW_SECONDS) * SAMPLE_RATE;
+}
+
+Fingerprint Fingerprint::Builder::finish() const {
+    auto const frames = Chroma::frames(mono_);
+    vector<uint32_t> codes{};
+    for (size_t t = 1; t < frames.size(); ++t)
+        codes.push_back(code(frames[t], frames[t - 1]));
+    return Fingerprint{std::move(codes)};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           b a n d s                              *
+ *                                                                  *
+ *******************************************************************/
+
+/// MinHash of the set of (stable bits of) codes, ROWS values per band.
+auto Fingerprint::bands() const noexcept
+-> array<int64_t, BANDS> {
+    array<uint64_t, HASHES> minimums{};
+    minimums.fill(numeric_limits<uint64_t>::max());
+    for (auto const code : codes_) {
+        auto const value = uint64_t(code & STABLE_BITS);
+        for (size_t k = 0; k < HASHES; ++k)
+            minimums[k] = std::min(minimums[k], mix(value ^ ((k + 1) * 0x9E37'79B9'7F4A'7C15)));
+    }
+
+    array<int64_t, BANDS> bands{};
+    for (size_t b = 0; b < BANDS; ++b) {
+        uint64_t key{};
+        for (size_t r = 0; r < ROWS; ++r)
+            key = mix(key ^ minimums[b * ROWS + r]);
+        bands[b] = int64_t(key);
+    }
+    return bands;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        d i s t a n c e                           *
+ *                                                                  *
+ *******************************************************************/
+
+/// The copies may start at slightly different moments (encoder delay,
+/// different silence), so the codes are compared at a few shifts.
+double Fingerprint::distance(Fingerprint const& other) const noexcept {
+    auto const& a = codes_;
+    auto const& b = other.codes_;
+    auto best = 1.;
+    for (auto shift = -MAX_SHIFT; shift <= MAX_SHIFT; ++shift) {
+        auto const first = size_t(std::max(0, -shift));
+        auto const last = std::min(a.size(), b.size() - std::min(b.size(), size_t(std::max(0, shift))));
+        if (last < first + MIN_CODES)
+            continue;
+        size_t errors{};
+        for (auto i = first; i < last; ++i)
+            errors += size_t(std::popcount(a[i] ^ b[i + shift]));
+        best = std::min(best, double(errors) / double(32 * (last - first)));
+    }
+    return best;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           b l o b                                *
+ *                                                                  *
+ *******************************************************************/
+
+vector<uint8_t> Fingerprint::to_blob() const {
+    vector<uint8_t> blob{};
+    blob.reserve(codes_.size() * 4);
+    for (auto const code : codes_)
+        for (int i = 0; i < 4; ++i)
+            blob.push_back(uint8_t(code >> (8 * i)));
+    return blob;
+}
+
+Fingerprint Fingerprint::from_blob(span<uint8_t const> const blob) {
+    vector<uint32_t> codes{};
+    codes.reserve(blob.size() / 4);
+    for (size_t i = 0; i + 3 < blob.size(); i += 4)
+        codes.push_back(uint32_t(blob[i]) | uint32_t(blob[i + 1]) << 8 | uint32_t(blob[i + 2]) << 16 | uint32_t(blob[i + 3]) << 24);
+    return Fingerprint{std::move(codes)};
+}
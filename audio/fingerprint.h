@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "chroma.h"
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*------- Fingerprint:
+-------------------------------------------------------------------*/
+/// Acoustic fingerprint of a recording, the same for its MP3 and M4A copies.
+/// WINDOW_SECONDS of the song (from its first sound) are mixed to mono at
+/// 11025 Hz, from every chroma frame (see Chroma) and the previous one
+/// comes one 32-bit code.
+/// Two recordings are the same when their codes differ in less than
+/// MAX_BIT_ERROR of bits (at the best shift). Candidates are found by LSH:
+/// MinHash of the set of codes, HASHES values in BANDS bands.
+class Fingerprint {
+public:
+    static constexpr int INPUT_RATE{44'100};
+    static constexpr int INPUT_CHANNELS{2};
+    static constexpr int DECIMATION{4};
+    static constexpr int SAMPLE_RATE{INPUT_RATE / DECIMATION};
+    static_assert(SAMPLE_RATE == Chroma::SAMPLE_RATE);
+    static constexpr int WINDOW_SECONDS{30};
+    static constexpr size_t MIN_CODES{16};
+    static constexpr int MAX_SHIFT{8};              // frames (~1.5 s)
+    static constexpr double MAX_BIT_ERROR{0.15};
+    static constexpr size_t BANDS{16};
+    static constexpr size_t ROWS{2};
+    static constexpr size_t HASHES{BANDS * ROWS};
+
+    /// Collects decoded PCM (INPUT_RATE, INPUT_CHANNELS, float) until the window is full.
+    class Builder {
+        std::vector<float> mono_{};
+        std::array<float, DECIMATION> pending_{};
+        int pending_count_{};
+        bool sound_{};                  // the first sound was heard
+    public:
+        Builder();
+        void add(float const* samples, size_t frames) noexcept;
+        bool complete() const noexcept;
+        /// Empty if the song was too short.
+        Fingerprint finish() const;
+        /// The collected window (mono, SAMPLE_RATE).
+        std::span<float const> mono() const noexcept { return mono_; }
+    };
+
+private:
+    std::vector<uint32_t> codes_{};
+public:
+    Fingerprint() = default;
+    explicit Fingerprint(std::vector<uint32_t> codes) : codes_{std::move(codes)} {}
+
+    bool empty() const noexcept { return codes_.size() < MIN_CODES; }
+    std::vector<uint32_t> const& codes() const noexcept { return codes_; }
+
+    /// LSH keys, one per band.
+    std::array<int64_t, BANDS> bands() const noexcept;
+    /// Share of different bits at the best alignment (0 - the same, ~0.5 - unrelated).
+    double distance(Fingerprint const& other) const noexcept;
+    bool same_recording(Fingerprint const& other) const noexcept {
+        return distance(other) < MAX_BIT_ERROR;
+    }
+
+    std::vector<uint8_t> to_blob() const;
+    static Fingerprint from_blob(std::span<uint8_t const> blob);
+};
@@ -0,0 +1,205 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "fingerprinter.h"
+#include "fingerprint.h"
+#include "tempo_key.h"
+#include "track.h"
+#include "../model/song_fingerprint.h"
+#include "../model/song_tempo.h"
+#include "../shared/event.hh"
+#include "../shared/event_controller.hh"
+#include <QUrl>
+#include <QStringList>
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <iostream>
+#include <format>
+using namespace std;
+
+static_assert(Fingerprint::INPUT_RATE == Track::SAMPLE_RATE && Fingerprint::INPUT_CHANNELS == Track::CHANNELS);
+
+/*------- Fingerprinter::Worker ::QObject:
+-------------------------------------------------------------------*/
+/// Lives in its own thread. Decodes the song until the builder
+/// has its window, then the decoder is stopped.
+class Fingerprinter::Worker : public QObject {
+    Fingerprinter* const fingerprinter_;
+    size_t const idx_;
+    QAudioDecoder* decoder_{};
+    string path_{};
+    optional<Fingerprint::Builder> builder_{};
+    bool decoding_{};
+public:
+    Worker(Fingerprinter* const fingerprinter, size_t const idx) :
+        fingerprinter_{fingerprinter},
+        idx_{idx}
+    {}
+    void next() noexcept;
+private:
+    void finish_song(bool ok) noexcept;
+};
+
+/********************************************************************
+ *                                                                  *
+ *                            n e x t                               *
+ *                                                                  *
+ *******************************************************************/
+
+void Fingerprinter::Worker::next() noexcept {
+    if (!decoder_) {
+        // Created here, so the decoder lives in our thread.
+        decoder_ = new QAudioDecoder(this);
+        decoder_->setAudioFormat(Track::format());
+        connect(decoder_, &QAudioDecoder::bufferReady, this, [this] {
+            auto const samples = Track::samples(decoder_->read());
+            if (!builder_)
+                return;
+            builder_->add(samples.data(), samples.size() / Track::CHANNELS);
+            if (builder_->complete())
+                finish_song(true);
+        });
+        connect(decoder_, &QAudioDecoder::finished, this, [this] {
+            finish_song(true);
+        });
+        connect(decoder_, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [this] (auto) {
+            cerr << format("Can't fingerprint {}: {}\n", path_, decoder_->errorString().toStdString()) << flush;
+            finish_song(false);
+        });
+    }
+    if (decoding_)
+        return;
+
+    if (auto path = fingerprinter_->take(idx_)) {
+        path_ = std::move(*path);
+        builder_.emplace();
+        decoding_ = true;
+        decoder_->setSource(QUrl::fromLocalFile(QString::fromStdString(path_)));
+        decoder_->start();
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                     f i n i s h _ s o n g                        *
+ *                                                                  *
+ *******************************************************************/
+
+/// A song that can't be decoded gets an empty fingerprint (and no tempo),
+/// so it isn't tried again until the file changes.
+void Fingerprinter::Worker::finish_song(bool const ok) noexcept {
+    if (!std::exchange(decoding_, false))
+        return;
+    decoder_->stop();
+
+    if (auto const stamp = SongTags::stamp(path_)) {
+        auto const fingerprint = ok ? builder_->finish() : Fingerprint{};
+        if (SongTempo::save(path_, *stamp, ok ? TempoKey::of(builder_->mono()) : TempoKey{}) && ok)
+            EventController::self().send(event::TempoFound, QString::fromStdString(path_));
+        if (SongFingerprint::save(path_, *stamp, fingerprint) && !fingerprint.empty())
+            if (auto const others = SongFingerprint::duplicates_of(path_); !others.empty()) {
+                QStringList paths{};
+                for (auto const& other : others)
+                    paths << QString::fromStdString(other);
+                EventController::self().send(event::DuplicatesFound, QString::fromStdString(path_), paths);
+            }
+    }
+    builder_.reset();
+    // Not from inside the decoder's signal.
+    QMetaObject::invokeMethod(this, &Worker::next, Qt::QueuedConnection);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                     F i n g e r p r i n t e r                    *
+ *                                                                  *
+ *******************************************************************/
+
+Fingerprinter::Fingerprinter(QObject* const parent, uint const workers) :
+    QObject{parent},
+    idle_(std::max(1u, workers), true)
+{
+    for (size_t i = 0; i < idle_.size(); ++i) {
+        auto& thread = threads_.emplace_back(make_unique<QThread>());
+        auto const worker = workers_.emplace_back(new Worker(this, i));
+        worker->moveToThread(thread.get());
+        connect(thread.get(), &QThread::finished, worker, &QObject::deleteLater);
+        thread->start(QThread::LowestPriority);
+    }
+}
+
+Fingerprinter::~Fingerprinter() {
+    {
+        lock_guard<mutex> lg{mutex_};
+        queue_.clear();
+    }
+    for (auto const& thread : threads_) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *              s t a r t   /   e n q u e u e   /   t a k e         *
+ *                                                                  *
+ *******************************************************************/
+
+/// The queries run in the first worker's thread, not in the caller's.
+void Fingerprinter::start() noexcept {
+    QMetaObject::invokeMethod(workers_.front(), [this] {
+        SongFingerprint::purge();
+        enqueue(SongFingerprint::pending());
+    });
+}
+
+void Fingerprinter::enqueue(vector<string>&& paths) noexcept {
+    vector<Worker*> idle{};
+    {
+        lock_guard<mutex> lg{mutex_};
+        queue_.assign(make_move_iterator(paths.begin()), make_move_iterator(paths.end()));
+        for (size_t i = 0; i < idle_.size() && i < queue_.size(); ++i)
+            if (idle_[i]) {
+                idle_[i] = false;
+                idle.push_back(workers_[i]);
+            }
+    }
+    for (auto const worker : idle)
+        QMetaObject::invokeMethod(worker, &Worker::next);
+}
+
+auto Fingerprinter::take(size_t const worker) noexcept
+-> optional<string> {
+    lock_guard<mutex> lg{mutex_};
+    if (queue_.empty()) {
+        idle_[worker] = true;
+        return {};
+    }
+    auto path = std::move(queue_.front());
+    queue_.pop_front();
+    return path;
+}
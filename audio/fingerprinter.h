@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <QObject>
+#include <QThread>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+
+/*------- Fingerprinter ::QObject:
+-------------------------------------------------------------------*/
+/// Makes acoustic fingerprints of all songs in the tags cache in background
+/// and pairs copies of the same recording (see SongFingerprint). The same
+/// window gives the song's tempo and key (see SongTempo).
+/// Only songs without a valid fingerprint are done, so after the first
+/// run only new or changed files cost anything. Every worker has its own
+/// low priority thread and decodes one song at a time, only as much of it
+/// as the fingerprint needs. Workers take songs from the shared queue
+/// as they finish, so a long song doesn't hold the others back.
+class Fingerprinter : public QObject {
+    Q_OBJECT
+    class Worker;
+
+    std::mutex mutex_{};                    // guards the queue and idle_
+    std::deque<std::string> queue_{};
+    std::vector<bool> idle_{};
+    std::vector<std::unique_ptr<QThread>> threads_{};
+    std::vector<Worker*> workers_{};
+public:
+    explicit Fingerprinter(QObject* parent = nullptr, uint workers = std::max(1u, std::thread::hardware_concurrency() / 2));
+    ~Fingerprinter();
+
+    /// Look for songs without fingerprints and fingerprint them (may be called from any thread).
+    void start() noexcept;
+
+private:
+    /// New content of the queue, idle workers are woken up.
+    void enqueue(std::vector<std::string>&& paths) noexcept;
+    /// The next song for the worker; if there is none, the worker becomes idle.
+    std::optional<std::string> take(size_t worker) noexcept;
+};
@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "limiter.h"
+#include <array>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    constexpr size_t LANES{8};
+}
+
+Limiter::Limiter(int const sample_rate) :
+    release_{1.f - exp(-1000.f / (RELEASE_MS * float(sample_rate)))}
+{
+    reset();
+}
+
+void Limiter::reset() noexcept {
+    delay_.assign(LOOKAHEAD * CHANNELS, 0.f);
+    required_.assign(LOOKAHEAD, 1.f);
+    held_.assign(LOOKAHEAD, 1.f);
+    held_sum_ = double(LOOKAHEAD);
+    pos_ = 0;
+    gain_ = 1.f;
+}
+
+void Limiter::process(vector<float>& block) noexcept {
+    auto const frames = block.size() / CHANNELS;
+    auto data = block.data();
+    for (size_t i = 0; i < frames; ++i, data += CHANNELS) {
+        auto peak = std::abs(data[0]);
+        for (int c = 1; c < CHANNELS; ++c)
+            peak = std::max(peak, std::abs(data[c]));
+        required_[pos_] = peak > THRESHOLD ? THRESHOLD / peak : 1.f;
+
+        // The lowest gain needed in the window. Separate minimums per lane,
+        // in this form the compiler vectorizes the loop.
+        array<float, LANES> lanes{};
+        lanes.fill(1.f);
+        for (size_t k = 0; k < LOOKAHEAD; k += LANES)
+            for (size_t j = 0; j < LANES; ++j)
+                lanes[j] = required_[k + j] < lanes[j] ? required_[k + j] : lanes[j];
+        auto const held = *std::min_element(lanes.begin(), lanes.end());
+        held_sum_ += double(held) - double(held_[pos_]);
+        held_[pos_] = held;
+        auto const smooth = float(held_sum_ / double(LOOKAHEAD));
+
+        gain_ = smooth < gain_ ? smooth : gain_ + (smooth - gain_) * release_;
+
+        // In goes the new frame, out goes the oldest one: the only frame
+        // all the minimums averaged in 'smooth' have seen.
+        std::copy_n(data, CHANNELS, delay_.data() + pos_ * CHANNELS);
+        pos_ = (pos_ + 1) % LOOKAHEAD;
+        auto const oldest = delay_.data() + pos_ * CHANNELS;
+        for (int c = 0; c < CHANNELS; ++c)
+            data[c] = oldest[c] * gain_;
+    }
+}
@@ -0,0 +1,61 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dsp_chain.h"
+#include <vector>
+
+/*------- Limiter ::DspStage:
+-------------------------------------------------------------------*/
+/// Look-ahead peak limiter: nothing goes out above THRESHOLD.
+/// The gain every frame needs is known LOOKAHEAD frames before the frame
+/// goes out; the minimum over that window is averaged over the window,
+/// so the gain comes down smoothly and is low enough when the peak comes.
+/// Then it goes back up with the RELEASE_MS time constant.
+/// The output is delayed by LOOKAHEAD - 1 frames (~1.5 ms).
+class Limiter : public DspStage {
+    static constexpr int CHANNELS{2};
+    static constexpr size_t LOOKAHEAD{64};            // a multiple of 8
+    static constexpr float THRESHOLD{0.966f};       // -0.3 dBFS
+    static constexpr float RELEASE_MS{80.f};
+
+    float const release_;
+    std::vector<float> delay_{};        // the last LOOKAHEAD frames (ring)
+    std::vector<float> required_{};     // gain the frames need (ring of LOOKAHEAD)
+    std::vector<float> held_{};         // minimum of 'required_' (ring of LOOKAHEAD)
+    size_t pos_{};
+    double held_sum_{};
+    float gain_{1.f};
+public:
+    explicit Limiter(int sample_rate);
+
+    char const* name() const noexcept override {
+        return "limiter";
+    }
+    void reset() noexcept override;
+    void process(std::vector<float>& block) noexcept override;
+};
@@ -0,0 +1,219 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "loudness.h"
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    // Loudness = -0.691 + 10 log10(mean square).
+    constexpr double OFFSET{-0.691};
+
+    double mean_square(double const lufs) noexcept {
+        return pow(10., (lufs - OFFSET) / 10.);
+    }
+}
+
+/// K-weighting for any sample rate, from the analog prototype of the
+/// BS.1770 filters (the published coefficients are for 48 kHz only).
+LoudnessMeter::LoudnessMeter(int const sample_rate, int const channels) :
+    channels_{std::clamp(channels, 1, MAX_CHANNELS)},
+    step_frames_{size_t(sample_rate / 10)}
+{
+    using std::numbers::pi;
+    auto const fs = double(sample_rate);
+    {
+        // Stage 1: high shelf, +4 dB above ~1.5 kHz (the head).
+        constexpr double f0{1681.974450955533}, gain_db{3.999843853973347}, q{0.7071752369554196};
+        auto const k = tan(pi * f0 / fs);
+        auto const vh = pow(10., gain_db / 20.);
+        auto const vb = pow(vh, 0.4996667741545416);
+        auto const a0 = 1. + k / q + k * k;
+        shelf_ = {
+            .b0 = (vh + vb * k / q + k * k) / a0,
+            .b1 = 2. * (k * k - vh) / a0,
+            .b2 = (vh - vb * k / q + k * k) / a0,
+            .a1 = 2. * (k * k - 1.) / a0,
+            .a2 = (1. - k / q + k * k) / a0
+        };
+    }
+    {
+        // Stage 2: high pass at ~38 Hz (RLB).
+        constexpr double f0{38.13547087602444}, q{0.5003270373238773};
+        auto const k = tan(pi * f0 / fs);
+        auto const a0 = 1. + k / q + k * k;
+        high_pass_ = {
+            .b0 = 1.,
+            .b1 = -2.,
+            .b2 = 1.,
+            .a1 = 2. * (k * k - 1.) / a0,
+            .a2 = (1. - k / q + k * k) / a0
+        };
+    }
+    for (auto& history : history_)
+        history.assign(TAPS - 1, 0.f);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            a d d                                 *
+ *                                                                  *
+ *******************************************************************/
+
+void LoudnessMeter::add(float const* const samples, size_t const frames) noexcept {
+    weigh(samples, frames);
+    measure_peak(samples, frames);
+}
+
+/// K-weighting and the mean square of every gating block.
+void LoudnessMeter::weigh(float const* const samples, size_t const frames) noexcept {
+    auto const filter = [] (Biquad const& f, array<double, 2>& s, double const x) {
+        auto const w = x - f.a1 * s[0] - f.a2 * s[1];
+        auto const y = f.b0 * w + f.b1 * s[0] + f.b2 * s[1];
+        s[1] = s[0];
+        s[0] = w;
+        return y;
+    };
+
+    for (size_t i = 0; i < frames; ++i) {
+        for (int c = 0; c < channels_; ++c) {
+            auto const y = filter(high_pass_, high_pass_state_[c],
+                                  filter(shelf_, shelf_state_[c], double(samples[i * channels_ + c])));
+            step_sum_ += y * y;
+        }
+        if (++step_filled_ < step_frames_)
+            continue;
+
+        // 100 ms are complete, the block is made of the last four.
+        steps_[steps_count_++ % steps_.size()] = step_sum_;
+        step_sum_ = 0.;
+        step_filled_ = 0;
+        if (steps_count_ >= steps_.size()) {
+            auto const sum = steps_[0] + steps_[1] + steps_[2] + steps_[3];
+            blocks_.push_back(sum / double(steps_.size() * step_frames_));
+        }
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                    m e a s u r e _ p e a k                       *
+ *                                                                  *
+ *******************************************************************/
+
+/// Every channel is copied out (after its history), then every phase
+/// of the interpolation is one multiply-add pass over the whole block.
+void LoudnessMeter::measure_peak(float const* const samples, size_t const frames) noexcept {
+    auto const& coefficients = interpolation();
+    channel_.resize(TAPS - 1 + frames);
+    interpolated_.resize(frames);
+
+    for (int c = 0; c < channels_; ++c) {
+        auto& history = history_[c];
+        std::copy(history.begin(), history.end(), channel_.begin());
+        for (size_t i = 0; i < frames; ++i)
+            channel_[TAPS - 1 + i] = samples[i * channels_ + c];
+
+        auto peak = peak_;
+        auto const x = channel_.data();
+        auto const y = interpolated_.data();
+        for (auto const& phase : coefficients) {
+            std::fill_n(y, frames, 0.f);
+            for (size_t k = 0; k < TAPS; ++k) {
+                auto const h = phase[k];
+                for (size_t i = 0; i < frames; ++i)
+                    y[i] += h * x[i + k];
+            }
+            for (size_t i = 0; i < frames; ++i)
+                peak = std::max(peak, std::abs(y[i]));
+        }
+        peak_ = peak;
+        std::copy(channel_.end() - (TAPS - 1), channel_.end(), history.begin());
+    }
+}
+
+/// Windowed sinc (low pass at the original Nyquist), split into phases:
+/// phase p gives the sample at p/PHASES between two input samples.
+/// Every phase is normalized, so DC passes with gain 1.
+auto LoudnessMeter::interpolation() noexcept
+-> array<array<float, TAPS>, PHASES> const& {
+    static auto const table = [] {
+        using std::numbers::pi;
+        constexpr auto n = PHASES * TAPS;
+        constexpr auto center = double(n - 1) / 2.;
+        array<array<float, TAPS>, PHASES> table{};
+        for (size_t p = 0; p < PHASES; ++p) {
+            double sum{};
+            array<double, TAPS> phase{};
+            for (size_t k = 0; k < TAPS; ++k) {
+                // Tap k works on channel_[i + k], i.e. input sample i - (TAPS - 1 - k).
+                auto const idx = (TAPS - 1 - k) * PHASES + p;
+                auto const t = (double(idx) - center) / double(PHASES);
+                auto const sinc = t == 0. ? 1. : sin(pi * t) / (pi * t);
+                auto const window = 0.5 - 0.5 * cos(2. * pi * (double(idx) + 0.5) / double(n));
+                sum += phase[k] = sinc * window;
+            }
+            for (size_t k = 0; k < TAPS; ++k)
+                table[p][k] = float(phase[k] / sum);
+        }
+        return table;
+    }();
+    return table;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                      i n t e g r a t e d                         *
+ *                                                                  *
+ *******************************************************************/
+
+/// The gates are compared in mean squares, so no logarithm per block.
+double LoudnessMeter::integrated(span<double const> const blocks) noexcept {
+    auto const gated_mean = [&blocks] (double const threshold) {
+        double sum{};
+        size_t count{};
+        for (auto const block : blocks)
+            if (block > threshold) {
+                sum += block;
+                ++count;
+            }
+        return count ? sum / double(count) : 0.;
+    };
+
+    auto const absolute = mean_square(ABSOLUTE_GATE);
+    auto const mean = gated_mean(absolute);
+    if (mean <= 0.)
+        return ABSOLUTE_GATE;
+    auto const relative = std::max(absolute, mean_square(lufs(mean) + RELATIVE_GATE));
+    return lufs(gated_mean(relative));
+}
+
+double LoudnessMeter::lufs(double const mean_square) noexcept {
+    return mean_square > 0. ? OFFSET + 10. * log10(mean_square) : ABSOLUTE_GATE;
+}
@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <array>
+#include <vector>
+#include <cstddef>
+
+/*------- LoudnessMeter:
+-------------------------------------------------------------------*/
+/// EBU R128 (ITU-R BS.1770-4) measurement of interleaved float PCM.
+/// Samples go through the K-weighting filter (high shelf + high pass),
+/// their mean square is taken in 400 ms gating blocks overlapping by 75%.
+/// The integrated loudness is the gated mean of the blocks (absolute gate
+/// -70 LUFS, relative gate -10 LU); blocks of several tracks together give
+/// the album loudness. The true peak is the peak of the signal oversampled 4x.
+/// The filters are recursive, so they run over all channels at once sample
+/// by sample; the squares and the oversampling are plain loops over a block,
+/// written so that the compiler vectorizes them.
+class LoudnessMeter {
+public:
+    static constexpr int MAX_CHANNELS{2};
+    static constexpr double ABSOLUTE_GATE{-70.};
+    static constexpr double RELATIVE_GATE{-10.};
+    // Oversampling of the true peak: phases x taps of the interpolation filter.
+    static constexpr size_t PHASES{4};
+    static constexpr size_t TAPS{12};
+private:
+    struct Biquad {
+        double b0{}, b1{}, b2{}, a1{}, a2{};
+    };
+    int const channels_;
+    size_t const step_frames_;                  // 100 ms
+    Biquad shelf_{};
+    Biquad high_pass_{};
+    // Filters' state (direct form II), per channel.
+    std::array<std::array<double, 2>, MAX_CHANNELS> shelf_state_{};
+    std::array<std::array<double, 2>, MAX_CHANNELS> high_pass_state_{};
+    // Sums of squares of the last four 100 ms steps, the current one is being filled.
+    std::array<double, 4> steps_{};
+    size_t steps_count_{};
+    double step_sum_{};
+    size_t step_filled_{};
+    std::vector<double> blocks_{};              // mean square of every gating block
+    // True peak: the last TAPS - 1 samples of every channel before the block.
+    std::array<std::vector<float>, MAX_CHANNELS> history_{};
+    std::vector<float> channel_{};
+    std::vector<float> interpolated_{};
+    float peak_{};
+
+public:
+    LoudnessMeter(int sample_rate, int channels);
+
+    /// Interleaved samples of 'frames' frames.
+    void add(float const* samples, size_t frames) noexcept;
+
+    std::vector<double> const& blocks() const noexcept {
+        return blocks_;
+    }
+    /// Linear (1.0 is full scale).
+    float true_peak() const noexcept {
+        return peak_;
+    }
+    double integrated() const noexcept {
+        return integrated(blocks_);
+    }
+    /// Integrated loudness (LUFS) of the gating blocks, ABSOLUTE_GATE if all are silent.
+    static double integrated(std::span<double const> blocks) noexcept;
+    static double lufs(double mean_square) noexcept;
+
+private:
+    void weigh(float const* samples, size_t frames) noexcept;
+    void measure_peak(float const* samples, size_t frames) noexcept;
+    static std::array<std::array<float, TAPS>, PHASES> const& interpolation() noexcept;
+};
@@ -0,0 +1,242 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "loudness_analyzer.h"
+#include "loudness.h"
+#include "track.h"
+#include "../model/dir_content.h"
+#include "../model/song_loudness.h"
+#include <QDir>
+#include <QUrl>
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <algorithm>
+#include <optional>
+#include <iostream>
+#include <format>
+using namespace std;
+
+/*------- LoudnessAnalyzer::Worker ::QObject:
+-------------------------------------------------------------------*/
+/// Lives in its own thread. Decodes the songs of the album one by one,
+/// every buffer goes straight to the meter (nothing is kept).
+class LoudnessAnalyzer::Worker : public QObject {
+    LoudnessAnalyzer* const analyzer_;
+    size_t const idx_;
+    QAudioDecoder* decoder_{};
+    QString album_{};
+    QStringList songs_{};
+    int song_{};
+    bool decoding_{};
+    optional<LoudnessMeter> meter_{};
+    vector<SongLoudness> results_{};
+    vector<double> album_blocks_{};
+    float album_peak_{};
+public:
+    Worker(LoudnessAnalyzer* const analyzer, size_t const idx) :
+        analyzer_{analyzer},
+        idx_{idx}
+    {}
+    void next() noexcept;
+private:
+    void start_song() noexcept;
+    void finish_song(bool ok) noexcept;
+    void finish_album() noexcept;
+};
+
+/********************************************************************
+ *                                                                  *
+ *                            n e x t                               *
+ *                                                                  *
+ *******************************************************************/
+
+void LoudnessAnalyzer::Worker::next() noexcept {
+    if (!decoder_) {
+        // Created here, so the decoder lives in our thread.
+        decoder_ = new QAudioDecoder(this);
+        decoder_->setAudioFormat(Track::format());
+        connect(decoder_, &QAudioDecoder::bufferReady, this, [this] {
+            auto const samples = Track::samples(decoder_->read());
+            if (meter_)
+                meter_->add(samples.data(), samples.size() / Track::CHANNELS);
+        });
+        connect(decoder_, &QAudioDecoder::finished, this, [this] {
+            finish_song(true);
+        });
+        connect(decoder_, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [this] (auto) {
+            cerr << format("Can't measure {}: {}\n", songs_[song_].toStdString(), decoder_->errorString().toStdString()) << flush;
+            finish_song(false);
+        });
+    }
+
+    while (auto album = analyzer_->take(idx_)) {
+        auto songs = songs_of(*album);
+        // Measured before and nothing has changed.
+        auto const measured = std::ranges::all_of(songs, [] (QString const& path) {
+            return SongLoudness::for_path(path.toStdString()).has_value();
+        });
+        if (songs.isEmpty() || measured)
+            continue;
+
+        album_ = std::move(*album);
+        songs_ = std::move(songs);
+        song_ = 0;
+        results_.clear();
+        album_blocks_.clear();
+        album_peak_ = 0.f;
+        start_song();
+        return;
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                         s o n g s                                *
+ *                                                                  *
+ *******************************************************************/
+
+void LoudnessAnalyzer::Worker::start_song() noexcept {
+    if (song_ >= songs_.size()) {
+        finish_album();
+        return;
+    }
+    meter_.emplace(Track::SAMPLE_RATE, Track::CHANNELS);
+    decoding_ = true;
+    decoder_->setSource(QUrl::fromLocalFile(songs_[song_]));
+    decoder_->start();
+}
+
+void LoudnessAnalyzer::Worker::finish_song(bool const ok) noexcept {
+    if (!std::exchange(decoding_, false))
+        return;
+    decoder_->stop();
+
+    auto const path = songs_[song_].toStdString();
+    if (auto const stamp = SongTags::stamp(path); ok && stamp && !meter_->blocks().empty()) {
+        results_.emplace_back(path, *stamp, meter_->integrated(), double(meter_->true_peak()));
+        album_blocks_.insert(album_blocks_.end(), meter_->blocks().begin(), meter_->blocks().end());
+        album_peak_ = std::max(album_peak_, meter_->true_peak());
+    }
+    meter_.reset();
+    ++song_;
+    // Not from inside the decoder's signal.
+    QMetaObject::invokeMethod(this, &Worker::start_song, Qt::QueuedConnection);
+}
+
+/// The album loudness is measured over the blocks of all its songs.
+void LoudnessAnalyzer::Worker::finish_album() noexcept {
+    auto const lufs = LoudnessMeter::integrated(album_blocks_);
+    for (auto& loudness : results_)
+        loudness.set_album(lufs, double(album_peak_));
+    if (!results_.empty() && SongLoudness::save_all(results_))
+        emit analyzer_->analyzed(album_);
+    next();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                  L o u d n e s s A n a l y z e r                 *
+ *                                                                  *
+ *******************************************************************/
+
+LoudnessAnalyzer::LoudnessAnalyzer(QObject* const parent, uint const workers) :
+    QObject{parent},
+    idle_(std::max(1u, workers), true)
+{
+    for (size_t i = 0; i < idle_.size(); ++i) {
+        auto& thread = threads_.emplace_back(make_unique<QThread>());
+        auto const worker = workers_.emplace_back(new Worker(this, i));
+        worker->moveToThread(thread.get());
+        connect(thread.get(), &QThread::finished, worker, &QObject::deleteLater);
+        thread->start(QThread::LowestPriority);
+    }
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer() {
+    {
+        lock_guard<mutex> lg{mutex_};
+        queue_.clear();
+    }
+    for (auto const& thread : threads_) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                 a n a l y z e   /   t a k e                      *
+ *                                                                  *
+ *******************************************************************/
+
+void LoudnessAnalyzer::analyze(QString const& album_dir) noexcept {
+    // The album as it is now: edited, added or removed songs change it.
+    SongTags::Stamp stamp{};
+    for (auto const& path : songs_of(album_dir))
+        if (auto const song = SongTags::stamp(path.toStdString())) {
+            stamp.mtime = std::max(stamp.mtime, song->mtime);
+            stamp.size += song->size;
+        }
+
+    Worker* idle{};
+    {
+        lock_guard<mutex> lg{mutex_};
+        if (auto const it = seen_.find(album_dir); it != seen_.end() && it->second == stamp)
+            return;
+        seen_[album_dir] = stamp;
+        if (auto const it = std::ranges::find(queue_, album_dir); it != queue_.end())
+            queue_.erase(it);
+        queue_.push_front(album_dir);
+        if (auto const it = std::find(idle_.begin(), idle_.end(), true); it != idle_.end()) {
+            *it = false;
+            idle = workers_[size_t(it - idle_.begin())];
+        }
+    }
+    if (idle)
+        QMetaObject::invokeMethod(idle, &Worker::next);
+}
+
+QStringList LoudnessAnalyzer::songs_of(QString const& album_dir) noexcept {
+    QDir const dir{album_dir};
+    QStringList songs{};
+    for (auto const& name : dir.entryList(QDir::Files, QDir::Name))
+        if (DirContent::is_song(name.toStdString()))
+            songs << dir.filePath(name);
+    return songs;
+}
+
+auto LoudnessAnalyzer::take(size_t const worker) noexcept
+-> optional<QString> {
+    lock_guard<mutex> lg{mutex_};
+    if (queue_.empty()) {
+        idle_[worker] = true;
+        return {};
+    }
+    auto album = std::move(queue_.front());
+    queue_.pop_front();
+    return album;
+}
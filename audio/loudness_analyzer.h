@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "../model/song_tags.h"
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <unordered_map>
+
+/*------- LoudnessAnalyzer ::QObject:
+-------------------------------------------------------------------*/
+/// Measures the loudness (EBU R128) of whole albums in background and saves
+/// it in the table 'song_loudness'. An album is a directory (the way the
+/// collection is organised). Albums wait in a queue, the latest request
+/// first (it is the one that is about to be played). Every worker has its
+/// own low priority thread and decodes songs of one album, one after another,
+/// as fast as the decoder goes. An album measured before (and not changed)
+/// is skipped; within a session an album is requested again only when
+/// its songs changed (their latest mtime or total size).
+class LoudnessAnalyzer : public QObject {
+    Q_OBJECT
+    class Worker;
+
+    std::mutex mutex_{};                    // guards the queue and idle_
+    std::deque<QString> queue_{};
+    std::unordered_map<QString, SongTags::Stamp> seen_{};  // albums requested, as they were
+    std::vector<bool> idle_{};
+    std::vector<std::unique_ptr<QThread>> threads_{};
+    std::vector<Worker*> workers_{};
+public:
+    explicit LoudnessAnalyzer(QObject* parent = nullptr, uint workers = std::max(1u, std::thread::hardware_concurrency() / 2));
+    ~LoudnessAnalyzer();
+
+    /// Measure the album (the directory), unless it was requested before as it is now.
+    void analyze(QString const& album_dir) noexcept;
+    /// Songs of the album, by name.
+    static QStringList songs_of(QString const& album_dir) noexcept;
+
+signals:
+    /// The album's songs are in the database (emitted from the worker's thread).
+    void analyzed(QString const& album_dir);
+
+private:
+    /// The next album for the worker; if there is none, the worker becomes idle.
+    std::optional<QString> take(size_t worker) noexcept;
+};
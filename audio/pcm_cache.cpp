@@ -0,0 +1,185 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "pcm_cache.h"
+#include <array>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    // 16-bit decoders give k/32768, such samples come back exactly.
+    constexpr float SCALE{32768.f};
+    constexpr size_t LANES{8};
+
+    float peak(float const* const samples, size_t const count) noexcept {
+        // Lanes: the compiler vectorizes it.
+        std::array<float, LANES> lanes{};
+        size_t i{};
+        for (; i + LANES <= count; i += LANES)
+            for (size_t k = 0; k < LANES; ++k)
+                lanes[k] = std::max(lanes[k], std::abs(samples[i + k]));
+        for (; i < count; ++i)
+            lanes[0] = std::max(lanes[0], std::abs(samples[i]));
+        return *std::ranges::max_element(lanes);
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            c h u n k                             *
+ *                                                                  *
+ *******************************************************************/
+
+PcmCache::Chunk::Chunk(float const* const samples, size_t const count, bool const compact) {
+    if (!compact) {
+        samples_.assign(samples, samples + count);
+        return;
+    }
+    // A chunk within full scale keeps the 16-bit grid, a louder one is scaled down.
+    scale_ = std::max(1.f, peak(samples, count));
+    auto const factor = SCALE / scale_;
+    compact_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        // Rounded half away from zero, without a branch (vectorized).
+        auto const value = samples[i] * factor + (samples[i] < 0.f ? -.5f : .5f);
+        compact_[i] = int16_t(std::clamp(value, -SCALE, SCALE - 1.f));
+    }
+}
+
+void PcmCache::Chunk::copy(size_t const first, size_t const count, float* const out, float const gain) const noexcept {
+    if (compact_.empty()) {
+        auto const data = samples_.data() + first;
+        for (size_t i = 0; i < count; ++i)
+            out[i] = data[i] * gain;
+        return;
+    }
+    auto const data = compact_.data() + first;
+    auto const factor = gain * scale_ / SCALE;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = float(data[i]) * factor;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           w r i t e r                            *
+ *                                                                  *
+ *******************************************************************/
+
+void PcmCache::Writer::add(ChunkPtr const& chunk) noexcept {
+    lock_guard<mutex> lg{cache_->mutex_};
+    auto const it = cache_->find(path_);
+    if (it == cache_->entries_.end() || it->writer != id_)
+        return;
+    it->first_frames.push_back(it->frames);
+    it->chunks.push_back(chunk);
+    it->frames += int64_t(chunk->size()) / cache_->channels_;
+    it->bytes += chunk->bytes();
+    cache_->bytes_ += chunk->bytes();
+    cache_->entries_.splice(cache_->entries_.begin(), cache_->entries_, it);
+    cache_->evict();
+}
+
+void PcmCache::Writer::finish() noexcept {
+    lock_guard<mutex> lg{cache_->mutex_};
+    if (auto const it = cache_->find(path_); it != cache_->entries_.end() && it->writer == id_) {
+        it->complete = true;
+        it->writer = 0;
+    }
+}
+
+PcmCache::PcmCache(int const channels, size_t const capacity_bytes, bool const compact) :
+    channels_{channels},
+    capacity_{capacity_bytes},
+    compact_{compact}
+{}
+
+/********************************************************************
+ *                                                                  *
+ *                          l e a s e                               *
+ *                                                                  *
+ *******************************************************************/
+
+auto PcmCache::lease(QString const& path, int64_t const frame) noexcept
+-> Lease {
+    Lease lease{};
+    lease.end_frame = frame;
+    lease.compact = compact_;
+
+    lock_guard<mutex> lg{mutex_};
+    auto const it = find(path);
+    if (it == entries_.end()) {
+        // Only a song decoded from its beginning is kept.
+        if (!frame) {
+            auto& entry = entries_.emplace_front();
+            entry.path = path;
+            entry.writer = ++writers_;
+            lease.writer.emplace(this, path, entry.writer);
+        }
+        return lease;
+    }
+    entries_.splice(entries_.begin(), entries_, it);
+    if (frame > it->frames)
+        return lease;
+
+    if (frame < it->frames) {
+        auto const first = std::upper_bound(it->first_frames.begin(), it->first_frames.end(), frame) - 1;
+        auto const idx = first - it->first_frames.begin();
+        lease.chunks.assign(it->chunks.begin() + idx, it->chunks.end());
+        lease.offset = size_t(frame - *first) * size_t(channels_);
+    }
+    lease.end_frame = it->frames;
+    lease.complete = it->complete;
+    if (!it->complete) {
+        // The decoder which kept it so far (if any) gives way.
+        it->writer = ++writers_;
+        lease.writer.emplace(this, path, it->writer);
+    }
+    return lease;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                      f i n d   /   e v i c t                     *
+ *                                                                  *
+ *******************************************************************/
+
+auto PcmCache::find(QString const& path) noexcept
+-> list<Entry>::iterator {
+    return std::find_if(entries_.begin(), entries_.end(), [&path] (Entry const& entry) {
+        return entry.path == path;
+    });
+}
+
+/// The least recently used songs go first; a song alone bigger than
+/// the capacity is not kept either.
+void PcmCache::evict() noexcept {
+    while (bytes_ > capacity_ && !entries_.empty()) {
+        bytes_ -= entries_.back().bytes;
+        entries_.pop_back();
+    }
+}
@@ -0,0 +1,126 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <QString>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+/*------- PcmCache:
+-------------------------------------------------------------------*/
+/// Decoded songs kept in memory, so a song played again or scrubbed back
+/// is read from here instead of being decoded again.
+/// A song is kept from its first frame on, as far as it was decoded
+/// (the whole song once the decoder finished). The samples are kept without
+/// the song's gain, in chunks as the decoder gave them. Compact chunks
+/// (optional) hold 16-bit samples scaled to the chunk's peak: half the memory,
+/// lossless only for 16-bit PCM sources (WAV, FLAC from CDs); lossy-coded
+/// songs have more precision than that and are requantized.
+/// The songs used least recently go when the memory is over the capacity.
+/// All functions may be called from any thread.
+class PcmCache {
+public:
+    /// Decoded samples of a song, never changed once kept.
+    class Chunk {
+        std::vector<float> samples_{};
+        std::vector<int16_t> compact_{};
+        float scale_{1.f};              // of the compact samples (overshoots above 1 stay)
+    public:
+        Chunk(float const* samples, size_t count, bool compact);
+        size_t size() const noexcept {
+            return compact_.empty() ? samples_.size() : compact_.size();
+        }
+        size_t bytes() const noexcept {
+            return samples_.size() * sizeof(float) + compact_.size() * sizeof(int16_t);
+        }
+        /// Copies 'count' samples from 'first' on to 'out', multiplied by the gain.
+        void copy(size_t first, size_t count, float* out, float gain) const noexcept;
+    };
+    using ChunkPtr = std::shared_ptr<Chunk const>;
+
+    /// Keeps what a decoder gives (in its thread), right after what is already kept.
+    class Writer {
+        PcmCache* cache_;
+        QString path_;
+        uint64_t id_;
+    public:
+        Writer(PcmCache* const cache, QString path, uint64_t const id) :
+            cache_{cache}, path_{std::move(path)}, id_{id}
+        {}
+        /// The song's next samples.
+        void add(ChunkPtr const& chunk) noexcept;
+        /// The song was decoded to the end.
+        void finish() noexcept;
+    };
+
+    /// What the cache has for a song from the given frame on.
+    struct Lease {
+        std::vector<ChunkPtr> chunks{};
+        size_t offset{};                // samples of the first chunk before the frame
+        int64_t end_frame{};            // the decoder has to go on from here
+        bool complete{};                // nothing more to decode
+        std::optional<Writer> writer{}; // what is decoded from end_frame on is kept
+        bool compact{};                 // how the decoded chunks are to be made
+    };
+private:
+    struct Entry {
+        QString path{};
+        std::vector<ChunkPtr> chunks{};
+        std::vector<int64_t> first_frames{};  // of every chunk
+        int64_t frames{};
+        size_t bytes{};
+        uint64_t writer{};              // only the latest writer adds
+        bool complete{};
+    };
+    int const channels_;
+    size_t const capacity_;
+    bool const compact_;
+    std::mutex mutex_{};
+    std::list<Entry> entries_{};        // the most recently used first
+    size_t bytes_{};
+    uint64_t writers_{};
+public:
+    PcmCache(int channels, size_t capacity_bytes, bool compact);
+    PcmCache(PcmCache const&) = delete;
+    PcmCache& operator=(PcmCache const&) = delete;
+
+    /// What is kept of the song from the frame on. Unless the song is complete,
+    /// the lease has a writer when the decoder's samples can follow what is kept.
+    Lease lease(QString const& path, int64_t frame) noexcept;
+    size_t bytes() noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        return bytes_;
+    }
+private:
+    // mutex_ must be locked.
+    std::list<Entry>::iterator find(QString const& path) noexcept;
+    void evict() noexcept;
+};
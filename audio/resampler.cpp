@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "resampler.h"
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <numbers>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    /// Modified Bessel function of the first kind, order 0 (for the Kaiser window).
+    double bessel_i0(double const x) noexcept {
+        double sum{1.}, term{1.};
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2. * k)) * (x / (2. * k));
+            sum += term;
+            if (term < 1e-12 * sum)
+                break;
+        }
+        return sum;
+    }
+
+    /// Dot product of the phase with the input (both contiguous), n is a multiple of LANES.
+    /// Separate sums per lane: the compiler may not reorder one float sum, these it vectorizes.
+    constexpr size_t LANES{8};
+    float dot(float const* __restrict const a, float const* __restrict const b, size_t const n) noexcept {
+        array<float, LANES> sums{};
+        for (size_t i = 0; i < n; i += LANES)
+            for (size_t k = 0; k < LANES; ++k)
+                sums[k] += a[i + k] * b[i + k];
+        float sum{};
+        for (auto const value : sums)
+            sum += value;
+        return sum;
+    }
+}
+
+Resampler::Resampler(int const in_rate, int const out_rate) {
+    auto const divisor = std::gcd(in_rate, out_rate);
+    up_ = size_t(out_rate / divisor);
+    down_ = size_t(in_rate / divisor);
+
+    // The prototype runs at in_rate * up. Its transition band (Kaiser's estimate for the
+    // length and the attenuation) ends at the lower of the two Nyquists, so nothing
+    // above it folds back; the cut-off is in the middle of the transition.
+    auto const length = up_ * TAPS;
+    auto const rate = double(in_rate) * double(up_);
+    auto const attenuation = KAISER_BETA / 0.1102 + 8.7;   // dB
+    auto const transition = (attenuation - 8.) / (2.285 * 2. * numbers::pi * double(length - 1)) * rate;
+    auto const cutoff = (0.5 * double(std::min(in_rate, out_rate)) - 0.5 * transition) / rate;
+    auto const middle = double(length - 1) / 2.;
+    auto const norm = bessel_i0(KAISER_BETA);
+    vector<double> prototype(length);
+    for (size_t k = 0; k < length; ++k) {
+        auto const t = double(k) - middle;
+        auto const sinc = t == 0. ? 2. * cutoff : sin(2. * numbers::pi * cutoff * t) / (numbers::pi * t);
+        auto const r = t / middle;
+        auto const window = bessel_i0(KAISER_BETA * sqrt(std::max(0., 1. - r * r))) / norm;
+        // Gain 'up': every phase gets only every up-th tap.
+        prototype[k] = sinc * window * double(up_);
+    }
+
+    // Phase p takes taps p, p + up, p + 2up ... applied to the input from the newest
+    // back; stored reversed, so they go with the input in time order.
+    coefficients_.resize(length);
+    for (size_t p = 0; p < up_; ++p)
+        for (size_t j = 0; j < TAPS; ++j)
+            coefficients_[p * TAPS + (TAPS - 1 - j)] = float(prototype[p + up_ * j]);
+    reset();
+}
+
+void Resampler::reset() noexcept {
+    for (auto& input : input_)
+        input.assign(TAPS - 1, 0.f);
+    next_ = TAPS - 1;
+    phase_ = 0;
+}
+
+void Resampler::process(vector<float>& block) noexcept {
+    auto const frames = block.size() / CHANNELS;
+    for (int c = 0; c < CHANNELS; ++c) {
+        auto& input = input_[c];
+        auto const first = input.size();
+        input.resize(first + frames);
+        for (size_t i = 0; i < frames; ++i)
+            input[first + i] = block[i * CHANNELS + c];
+    }
+
+    block.clear();
+    auto const available = input_[0].size();
+    while (next_ < available) {
+        auto const taps = coefficients_.data() + phase_ * TAPS;
+        for (int c = 0; c < CHANNELS; ++c)
+            block.push_back(dot(taps, input_[c].data() + next_ + 1 - TAPS, TAPS));
+        phase_ += down_;
+        next_ += phase_ / up_;
+        phase_ %= up_;
+    }
+
+    // Only the history the next outputs need stays.
+    auto const keep_from = std::min(next_ + 1, available) - (TAPS - 1);
+    for (auto& input : input_)
+        input.erase(input.begin(), input.begin() + long(keep_from));
+    next_ -= keep_from;
+}
@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dsp_chain.h"
+#include <array>
+#include <vector>
+
+/*------- Resampler ::DspStage:
+-------------------------------------------------------------------*/
+/// Polyphase resampler by the rational ratio out/in (e.g. 44100 -> 48000
+/// is 160/147). The prototype low-pass (Kaiser windowed sinc, its stop band
+/// starting at the lower Nyquist) is split into 'up' phases of TAPS taps; every
+/// output sample is one dot product of a phase with the last TAPS input
+/// samples. The input is kept per channel (not interleaved), so the dot
+/// products run over contiguous memory and are vectorized.
+class Resampler : public DspStage {
+    static constexpr int CHANNELS{2};
+    // 128 taps: the transition band is ~1.9 kHz at 44.1 kHz, the pass band reaches 20 kHz.
+    static constexpr size_t TAPS{128};              // a multiple of 8 (see dot)
+    static constexpr double KAISER_BETA{8.6};       // ~ -86 dB stop band
+
+    size_t up_{};
+    size_t down_{};
+    std::vector<float> coefficients_{};                 // phase after phase, taps in time order
+    std::array<std::vector<float>, CHANNELS> input_{};  // history + the new block, per channel
+    size_t next_{};         // input index of the newest sample of the next output
+    size_t phase_{};
+public:
+    Resampler(int in_rate, int out_rate);
+
+    char const* name() const noexcept override {
+        return "resampler";
+    }
+    void reset() noexcept override;
+    void process(std::vector<float>& block) noexcept override;
+    size_t max_frames(size_t const frames) const noexcept override {
+        return (frames * up_ + down_ - 1) / down_ + 1;
+    }
+};
@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <bit>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+/*------- RingBuffer:
+-------------------------------------------------------------------*/
+/// Lock-free ring buffer for exactly one producer and one consumer thread.
+/// Neither side ever waits or allocates: write() takes as much as fits,
+/// read() gives as much as there is. The capacity is rounded up to a power of two.
+template<typename T>
+class RingBuffer {
+    static constexpr size_t CACHE_LINE{64};
+    std::vector<T> data_;
+    size_t const mask_;
+    alignas(CACHE_LINE) std::atomic<size_t> head_{};    // moved by the producer
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{};    // moved by the consumer
+public:
+    explicit RingBuffer(size_t const capacity) :
+        data_(std::bit_ceil(std::max<size_t>(capacity, 2))),
+        mask_{data_.size() - 1}
+    {}
+    RingBuffer(RingBuffer const&) = delete;
+    RingBuffer& operator=(RingBuffer const&) = delete;
+
+    size_t capacity() const noexcept { return data_.size(); }
+    size_t size() const noexcept {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    size_t free() const noexcept { return capacity() - size(); }
+
+    /// Producer only. Returns the number of items written.
+    size_t write(T const* const src, size_t n) noexcept {
+        auto const head = head_.load(std::memory_order_relaxed);
+        auto const tail = tail_.load(std::memory_order_acquire);
+        n = std::min(n, capacity() - (head - tail));
+        auto const idx = head & mask_;
+        auto const first = std::min(n, capacity() - idx);
+        std::copy_n(src, first, data_.data() + idx);
+        std::copy_n(src + first, n - first, data_.data());
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Consumer only. Returns the number of items read.
+    size_t read(T* const dst, size_t n) noexcept {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        auto const head = head_.load(std::memory_order_acquire);
+        n = std::min(n, head - tail);
+        auto const idx = tail & mask_;
+        auto const first = std::min(n, capacity() - idx);
+        std::copy_n(data_.data() + idx, first, dst);
+        std::copy_n(data_.data(), n - first, dst + first);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Position after the last item written (items ever written).
+    size_t written() const noexcept {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    /// Consumer only. Drops the items before the position (see written()).
+    size_t discard(size_t const position) noexcept {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        auto const head = head_.load(std::memory_order_acquire);
+        auto const until = std::clamp(position, tail, head);
+        tail_.store(until, std::memory_order_release);
+        return until - tail;
+    }
+};
@@ -0,0 +1,267 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "seek_index.h"
+#include <span>
+#include <array>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace {
+    // How much we read at once to find the first frame and its Xing/VBRI header.
+    constexpr size_t HEAD_SIZE{64 * 1024};
+
+    uint32_t be32(uint8_t const* const p) noexcept {
+        return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+    }
+    uint16_t be16(uint8_t const* const p) noexcept {
+        return uint16_t(p[0] << 8 | p[1]);
+    }
+
+    /// MPEG audio (layer III) frame header.
+    struct Frame {
+        bool mpeg1{};
+        bool mono{};
+        int bitrate{};          // kbit/s
+        int sample_rate{};
+        int bytes{};            // with padding
+        int samples{};          // per frame
+
+        static optional<Frame> parse(uint8_t const* const p) noexcept {
+            static constexpr array<int, 16> MPEG1_BITRATES{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
+            static constexpr array<int, 16> MPEG2_BITRATES{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0};
+            static constexpr array<int, 3> MPEG1_RATES{44100, 48000, 32000};
+
+            auto const h = be32(p);
+            if ((h & 0xFFE00000) != 0xFFE00000)
+                return {};
+            auto const version = (h >> 19) & 3;     // 0: 2.5, 1: reserved, 2: 2, 3: 1
+            auto const layer = (h >> 17) & 3;       // 1: III
+            auto const bitrate_idx = (h >> 12) & 0xF;
+            auto const rate_idx = (h >> 10) & 3;
+            if (version == 1 || layer != 1 || bitrate_idx == 0 || bitrate_idx == 15 || rate_idx == 3)
+                return {};
+
+            Frame frame{};
+            frame.mpeg1 = version == 3;
+            frame.mono = ((h >> 6) & 3) == 3;
+            frame.bitrate = frame.mpeg1 ? MPEG1_BITRATES[bitrate_idx] : MPEG2_BITRATES[bitrate_idx];
+            frame.sample_rate = MPEG1_RATES[rate_idx] >> (version == 3 ? 0 : version == 2 ? 1 : 2);
+            frame.samples = frame.mpeg1 ? 1152 : 576;
+            frame.bytes = (frame.mpeg1 ? 144 : 72) * frame.bitrate * 1000 / frame.sample_rate + int((h >> 9) & 1);
+            return frame;
+        }
+        /// Where the Xing/Info header would be (after the side information).
+        int xing_offset() const noexcept {
+            return 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+        }
+    };
+
+    /// Size of the ID3v2 tag at the beginning of the file (0 if there is none).
+    int64_t id3v2_size(int const fd) noexcept {
+        array<uint8_t, 10> header{};
+        if (::pread(fd, header.data(), header.size(), 0) != ssize_t(header.size()))
+            return {};
+        if (header[0] != 'I' || header[1] != 'D' || header[2] != '3')
+            return {};
+        // Syncsafe integer: 7 bits per byte.
+        auto const size = int64_t(header[6] & 0x7F) << 21 | int64_t(header[7] & 0x7F) << 14
+                        | int64_t(header[8] & 0x7F) << 7 | int64_t(header[9] & 0x7F);
+        auto const footer = (header[5] & 0x10) ? 10 : 0;
+        return 10 + size + footer;
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        f o r _ p a t h                           *
+ *                                                                  *
+ *******************************************************************/
+
+shared_ptr<SeekIndex const> SeekIndex::for_path(string const& path) noexcept {
+    {
+        lock_guard<mutex> lg{mutex_};
+        if (auto const it = cache_.find(path); it != cache_.end())
+            return it->second;
+    }
+
+    shared_ptr<SeekIndex const> index{};
+    if (auto data = read(path))
+        index = make_shared<SeekIndex const>(std::move(*data));
+
+    lock_guard<mutex> lg{mutex_};
+    // We seek in a few songs at a time, the cache doesn't need to be smart.
+    if (cache_.size() >= CACHE_SIZE)
+        cache_.clear();
+    cache_.emplace(path, index);
+    return index;
+}
+
+auto SeekIndex::read(string const& path) noexcept
+-> optional<SeekIndex> {
+    auto const ext = path.substr(path.rfind('.') + 1);
+    if (ext == "mp3" || ext == "MP3")
+        return read_mp3(path);
+    return {};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            f i n d                               *
+ *                                                                  *
+ *******************************************************************/
+
+auto SeekIndex::find(int64_t const ms) const noexcept
+-> optional<Point> {
+    if (ms <= 0 || ms >= duration_ms_)
+        return {};
+
+    if (bytes_per_second_) {
+        // CBR: all frames have the same size (padding aside).
+        auto const frame = (ms * bytes_per_second_ / 1000) / frame_bytes_;
+        if (!frame)
+            return {};
+        auto const offset = audio_start_ + frame * frame_bytes_;
+        return Point{(offset - audio_start_) * 1000 / bytes_per_second_, offset};
+    }
+
+    auto const it = std::ranges::upper_bound(points_, ms, {}, &Point::ms);
+    if (it == points_.begin() || (it - 1)->ms == 0)
+        return {};
+    return *(it - 1);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        r e a d _ m p 3                           *
+ *                                                                  *
+ *******************************************************************/
+
+auto SeekIndex::read_mp3(string const& path) noexcept
+-> optional<SeekIndex> {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return {};
+
+    struct stat st{};
+    vector<uint8_t> head(HEAD_SIZE);
+    auto const start = id3v2_size(fd);
+    auto const n = (::fstat(fd, &st) == 0) ? ::pread(fd, head.data(), head.size(), start) : -1;
+    ::close(fd);
+    if (n < 4)
+        return {};
+    span<uint8_t const> const data{head.data(), size_t(n)};
+
+    // The first frame: a valid header followed by another valid header.
+    optional<Frame> frame{};
+    size_t pos{};
+    for (; pos + 4 <= data.size(); ++pos) {
+        if (data[pos] != 0xFF)
+            continue;
+        if ((frame = Frame::parse(&data[pos]))) {
+            auto const next = pos + size_t(frame->bytes);
+            if (next + 4 > data.size() || Frame::parse(&data[next]))
+                break;
+        }
+        frame.reset();
+    }
+    if (!frame)
+        return {};
+
+    SeekIndex index{};
+    index.audio_start_ = start + int64_t(pos);
+    auto const audio_bytes = int64_t(st.st_size) - index.audio_start_;
+    auto const frame_ms = [&frame] (int64_t const frames) {
+        return frames * frame->samples * 1000 / frame->sample_rate;
+    };
+
+    // Xing (VBR) or Info (CBR written by LAME).
+    if (auto const x = pos + size_t(frame->xing_offset()); x + 8 <= data.size()) {
+        auto const tag = data.subspan(x, 4);
+        if (std::ranges::equal(tag, string_view{"Xing"}) || std::ranges::equal(tag, string_view{"Info"})) {
+            auto const flags = be32(&data[x + 4]);
+            auto p = x + 8;
+            int64_t frames{}, bytes{audio_bytes};
+            if ((flags & 1) && p + 4 <= data.size()) {
+                frames = be32(&data[p]);
+                p += 4;
+            }
+            if ((flags & 2) && p + 4 <= data.size()) {
+                bytes = be32(&data[p]);
+                p += 4;
+            }
+            if (!frames)
+                return {};
+            index.duration_ms_ = frame_ms(frames);
+            if ((flags & 4) && p + 100 <= data.size()) {
+                // TOC: for every percent of the time, the position in 1/256 of the stream.
+                index.points_.reserve(100);
+                for (int i = 0; i < 100; ++i)
+                    index.points_.push_back({index.duration_ms_ * i / 100, index.audio_start_ + int64_t(data[p + i]) * bytes / 256});
+                return index;
+            }
+            // No TOC, we can only treat the file as CBR.
+            index.bytes_per_second_ = bytes * 1000 / std::max<int64_t>(1, index.duration_ms_);
+            index.frame_bytes_ = std::max<int64_t>(1, bytes / frames);
+            return index;
+        }
+    }
+
+    // VBRI (Fraunhofer), always 32 bytes after the header.
+    if (auto const v = pos + 36; v + 26 <= data.size() && std::ranges::equal(data.subspan(v, 4), string_view{"VBRI"})) {
+        auto const frames = int64_t(be32(&data[v + 14]));
+        auto const entries = be16(&data[v + 18]);
+        auto const scale = be16(&data[v + 20]);
+        auto const entry_size = be16(&data[v + 22]);
+        auto const frames_per_entry = be16(&data[v + 24]);
+        if (!frames || entry_size < 1 || entry_size > 4)
+            return {};
+        index.duration_ms_ = frame_ms(frames);
+
+        auto p = v + 26;
+        auto offset = index.audio_start_;
+        index.points_.reserve(entries + 1);
+        index.points_.push_back({0, offset});
+        for (int i = 0; i < entries && p + entry_size <= data.size(); ++i, p += entry_size) {
+            int64_t value{};
+            for (int b = 0; b < entry_size; ++b)
+                value = value << 8 | data[p + b];
+            offset += value * scale;
+            index.points_.push_back({frame_ms(int64_t(i + 1) * frames_per_entry), offset});
+        }
+        return index;
+    }
+
+    // Plain CBR.
+    index.bytes_per_second_ = int64_t(frame->bitrate) * 1000 / 8;
+    index.frame_bytes_ = int64_t(frame->samples / 8) * frame->bitrate * 1000 / frame->sample_rate;
+    index.duration_ms_ = audio_bytes * 1000 / index.bytes_per_second_;
+    return index;
+}
@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+/*------- SeekIndex:
+-------------------------------------------------------------------*/
+/// Where in an MP3 file to start reading to land at the given time,
+/// so the decoder doesn't have to go through everything before it.
+/// Built from the Xing/Info TOC, the VBRI table or (for CBR files)
+/// from the bitrate; only the headers are read.
+/// Other formats have no index (they are decoded from the beginning).
+class SeekIndex {
+public:
+    struct Point {
+        int64_t ms{};
+        int64_t offset{};
+    };
+private:
+    static constexpr size_t CACHE_SIZE{64};
+    static inline std::mutex mutex_{};
+    static inline std::unordered_map<std::string, std::shared_ptr<SeekIndex const>> cache_{};
+
+    int64_t duration_ms_{};
+    std::vector<Point> points_{};       // VBR: ascending in both fields
+    int64_t audio_start_{};             // CBR: offset of the first frame,
+    int64_t bytes_per_second_{};        //      its bitrate
+    int64_t frame_bytes_{};             //      and frame size (without padding)
+public:
+    /// Index of the file (cached), nullptr if the file has none.
+    static std::shared_ptr<SeekIndex const> for_path(std::string const& path) noexcept;
+    /// Index of the file read now (bypassing the cache).
+    static std::optional<SeekIndex> read(std::string const& path) noexcept;
+
+    /// The frame at or before the position (never the beginning of the file).
+    std::optional<Point> find(int64_t ms) const noexcept;
+    int64_t duration_ms() const noexcept {
+        return duration_ms_;
+    }
+private:
+    static std::optional<SeekIndex> read_mp3(std::string const& path) noexcept;
+};
@@ -0,0 +1,202 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "tempo_key.h"
+#include "chroma.h"
+#include "fft.h"
+#include <array>
+#include <cmath>
+#include <vector>
+#include <numbers>
+#include <numeric>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    // Krumhansl-Kessler key profiles (tonic first).
+    constexpr array<double, 12> MAJOR_PROFILE{6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88};
+    constexpr array<double, 12> MINOR_PROFILE{6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17};
+    constexpr array<char const*, 12> NAMES{"C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B"};
+    // Frames of the moving average removed from the onset envelope (~0.75 s).
+    constexpr size_t AVERAGE_FRAMES{64};
+
+    /// Pearson correlation of the chroma with the profile rotated to the tonic.
+    double correlation(array<double, 12> const& chroma, array<double, 12> const& profile, int const tonic) noexcept {
+        auto const mean_c = std::accumulate(chroma.begin(), chroma.end(), 0.) / 12.;
+        auto const mean_p = std::accumulate(profile.begin(), profile.end(), 0.) / 12.;
+        double cp{}, cc{}, pp{};
+        for (int i = 0; i < 12; ++i) {
+            auto const c = chroma[(tonic + i) % 12] - mean_c;
+            auto const p = profile[i] - mean_p;
+            cp += c * p;
+            cc += c * c;
+            pp += p * p;
+        }
+        return (cc > 0. && pp > 0.) ? cp / sqrt(cc * pp) : 0.;
+    }
+}
+
+TempoKey TempoKey::of(span<float const> const mono) {
+    return TempoKey{.bpm = tempo(mono), .key = key_of(mono)};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           t e m p o                              *
+ *                                                                  *
+ *******************************************************************/
+
+double TempoKey::tempo(span<float const> const mono) {
+    static Fft const fft{FRAME};
+    static auto const window = [] {
+        vector<float> window(FRAME);
+        for (size_t i = 0; i < FRAME; ++i)
+            window[i] = float(0.5 - 0.5 * cos(2. * numbers::pi * double(i) / double(FRAME - 1)));
+        return window;
+    }();
+    constexpr double FRAMES_PER_SECOND{double(Chroma::SAMPLE_RATE) / double(HOP)};
+    if (mono.size() < FRAME)
+        return {};
+
+    // Onset envelope: how much the (log) spectrum grows from frame to frame.
+    vector<float> re(FRAME), im(FRAME), magnitude(FRAME / 2), previous(FRAME / 2);
+    vector<double> onsets{};
+    onsets.reserve((mono.size() - FRAME) / HOP + 1);
+    for (size_t pos = 0; pos + FRAME <= mono.size(); pos += HOP) {
+        for (size_t i = 0; i < FRAME; ++i)
+            re[i] = mono[pos + i] * window[i];
+        std::fill(im.begin(), im.end(), 0.f);
+        fft.transform(re.data(), im.data());
+        for (size_t bin = 0; bin < FRAME / 2; ++bin)
+            magnitude[bin] = log1p(100.f * sqrt(re[bin] * re[bin] + im[bin] * im[bin]));
+        float flux{};
+        for (size_t bin = 1; bin < FRAME / 2; ++bin)
+            flux += std::max(0.f, magnitude[bin] - previous[bin]);
+        onsets.push_back(pos ? double(flux) : 0.);
+        std::swap(magnitude, previous);
+    }
+
+    // Only what sticks out of the local average.
+    vector<double> envelope(onsets.size());
+    double sum{};
+    for (size_t i = 0; i < onsets.size(); ++i) {
+        sum += onsets[i];
+        if (i >= AVERAGE_FRAMES)
+            sum -= onsets[i - AVERAGE_FRAMES];
+        auto const average = sum / double(std::min(i + 1, AVERAGE_FRAMES));
+        envelope[i] = std::max(0., onsets[i] - average);
+    }
+
+    auto const min_lag = size_t(FRAMES_PER_SECOND * 60. / MAX_BPM);
+    auto const max_lag = size_t(ceil(FRAMES_PER_SECOND * 60. / MIN_BPM));
+    if (envelope.size() < 2 * max_lag)
+        return {};
+    vector<double> scores(max_lag + 2);
+    for (auto lag = min_lag - 1; lag <= max_lag + 1; ++lag) {
+        double acf{};
+        for (size_t i = lag; i < envelope.size(); ++i)
+            acf += envelope[i] * envelope[i - lag];
+        auto const bpm = FRAMES_PER_SECOND * 60. / double(lag);
+        auto const octaves = log2(bpm / PREFERRED_BPM);
+        scores[lag] = acf / double(envelope.size() - lag) * exp(-0.5 * octaves * octaves);
+    }
+    auto const best = size_t(std::max_element(scores.begin() + long(min_lag), scores.begin() + long(max_lag) + 1) - scores.begin());
+    if (scores[best] <= 0.)
+        return {};
+
+    // The peak between lags (parabola through the neighbours).
+    auto const a = scores[best - 1], b = scores[best], c = scores[best + 1];
+    auto const denominator = a - 2. * b + c;
+    auto const shift = denominator < 0. ? std::clamp(0.5 * (a - c) / denominator, -0.5, 0.5) : 0.;
+    return FRAMES_PER_SECOND * 60. / (double(best) + shift);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                             k e y                                *
+ *                                                                  *
+ *******************************************************************/
+
+int TempoKey::key_of(span<float const> const mono) {
+    array<double, 12> chroma{};
+    for (auto const& frame : Chroma::frames(mono))
+        for (int i = 0; i < 12; ++i)
+            chroma[i] += frame[i];
+    if (std::accumulate(chroma.begin(), chroma.end(), 0.) <= 0.)
+        return NO_KEY;
+
+    auto key = NO_KEY;
+    auto best = -1.;
+    for (int tonic = 0; tonic < 12; ++tonic) {
+        if (auto const r = correlation(chroma, MAJOR_PROFILE, tonic); r > best) {
+            best = r;
+            key = tonic;
+        }
+        if (auto const r = correlation(chroma, MINOR_PROFILE, tonic); r > best) {
+            best = r;
+            key = 12 + tonic;
+        }
+    }
+    return key;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          n a m e s                               *
+ *                                                                  *
+ *******************************************************************/
+
+string TempoKey::key_name(int const key) {
+    if (key < 0 || key >= KEYS)
+        return {};
+    return string{NAMES[key % 12]} + (key >= 12 ? "m" : "");
+}
+
+/// C major is 8B, a fifth up is one position further;
+/// a minor key has the number of its relative major (three semitones up).
+int TempoKey::camelot_number(int const key) noexcept {
+    if (key < 0 || key >= KEYS)
+        return 0;
+    auto const major = key < 12 ? key : (key + 3) % 12;
+    return (7 * major + 7) % 12 + 1;
+}
+
+string TempoKey::camelot(int const key) {
+    if (auto const number = camelot_number(key))
+        return to_string(number) + (key >= 12 ? 'A' : 'B');
+    return {};
+}
+
+bool TempoKey::compatible(int const a, int const b) noexcept {
+    auto const na = camelot_number(a);
+    auto const nb = camelot_number(b);
+    if (!na || !nb)
+        return false;
+    auto const distance = std::abs(na - nb);
+    // The same position (the key or its relative), or a neighbour in the same mode.
+    return distance == 0 || ((distance == 1 || distance == 11) && (a >= 12) == (b >= 12));
+}
@@ -0,0 +1,70 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <string>
+
+/*------- TempoKey:
+-------------------------------------------------------------------*/
+/// Tempo and musical key of a piece of mono PCM (Chroma::SAMPLE_RATE).
+/// Tempo: the onset envelope (spectral flux of short frames, log magnitude)
+/// is autocorrelated over lags of MIN_BPM..MAX_BPM; the lags are weighted
+/// towards PREFERRED_BPM (log-normal, one octave), so a beat isn't taken
+/// for its half or double.
+/// Key: the average chroma is correlated with the Krumhansl-Kessler profiles
+/// of all 24 keys, the best one wins.
+class TempoKey {
+    static constexpr size_t FRAME{1024};
+    static constexpr size_t HOP{128};
+    static constexpr double MIN_BPM{60.};
+    static constexpr double MAX_BPM{200.};
+    static constexpr double PREFERRED_BPM{120.};
+public:
+    static constexpr int NO_KEY{-1};
+    /// Keys: 0-11 major (C, C#, ... B), 12-23 minor (Cm, C#m, ... Bm).
+    static constexpr int KEYS{24};
+
+    double bpm{};               // 0 if unknown
+    int key{NO_KEY};
+
+    static TempoKey of(std::span<float const> mono);
+
+    /// "C", "F#m", ...
+    static std::string key_name(int key);
+    /// Position on the Camelot wheel (1-12), the keys a DJ mixes with
+    /// are on the same or the neighbouring positions.
+    static int camelot_number(int key) noexcept;
+    /// "8B" (C major), "8A" (A minor), ...
+    static std::string camelot(int key);
+    /// The same key, its relative, or a fifth up or down (neighbours on the wheel).
+    static bool compatible(int a, int b) noexcept;
+
+private:
+    static double tempo(std::span<float const> mono);
+    static int key_of(std::span<float const> mono);
+};
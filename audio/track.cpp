@@ -0,0 +1,292 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "track.h"
+#include <QUrl>
+#include <QFile>
+#include <QIODevice>
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <algorithm>
+#include <iostream>
+#include <format>
+using namespace std;
+
+namespace {
+    /// The file from 'offset' on, for the decoder it is the whole file.
+    class Slice : public QIODevice {
+        QFile file_;
+        qint64 const offset_;
+    public:
+        Slice(QString const& path, qint64 const offset, QObject* const parent) :
+            QIODevice{parent},
+            file_{path},
+            offset_{offset}
+        {}
+        bool open(OpenMode const mode) override {
+            return file_.open(QIODevice::ReadOnly) && file_.seek(offset_) && QIODevice::open(mode | QIODevice::Unbuffered);
+        }
+        void close() override {
+            file_.close();
+            QIODevice::close();
+        }
+        qint64 size() const override {
+            return std::max<qint64>(0, file_.size() - offset_);
+        }
+        bool seek(qint64 const pos) override {
+            return QIODevice::seek(pos) && file_.seek(offset_ + pos);
+        }
+    protected:
+        qint64 readData(char* const data, qint64 const size) override {
+            return file_.read(data, size);
+        }
+        qint64 writeData(char const*, qint64) override {
+            return -1;
+        }
+    };
+}
+
+QAudioFormat Track::format() noexcept {
+    QAudioFormat format{};
+    format.setSampleRate(SAMPLE_RATE);
+    format.setChannelCount(CHANNELS);
+    format.setSampleFormat(QAudioFormat::Float);
+    return format;
+}
+
+Track::Track(QString path, float const gain, qint64 const start_ms, optional<SeekIndex::Point> const entry,
+             PcmCache::Lease lease) :
+    path_{std::move(path)},
+    start_frame_{start_ms * SAMPLE_RATE / 1000},
+    entry_{entry},
+    base_frame_{entry ? entry->ms * SAMPLE_RATE / 1000 : 0},
+    decode_frame_{std::max(start_frame_, lease.end_frame)},
+    gain_{gain},
+    cached_whole_{lease.complete},
+    writer_{entry ? nullopt : std::move(lease.writer)},
+    compact_{lease.compact},
+    chunks_{lease.chunks.begin(), lease.chunks.end()},
+    offset_{lease.offset}
+{
+    buffered_ = std::max<qint64>(0, lease.end_frame - start_frame_);
+    if (cached_whole_)
+        duration_ms_ = lease.end_frame * 1000 / SAMPLE_RATE;
+    else if (!start_frame_)
+        prefix_ = std::move(lease.chunks);
+}
+
+Track::~Track() {
+    if (decoder_)
+        decoder_->stop();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          s t a r t                               *
+ *                                                                  *
+ *******************************************************************/
+
+void Track::start() noexcept {
+    if (cached_whole_) {
+        decoded_ = true;
+        return;
+    }
+    if (!start_frame_) {
+        builder_.emplace(CHANNELS);
+        // The waveform starts with what the cache kept.
+        vector<float> samples{};
+        for (auto const& chunk : std::exchange(prefix_, {})) {
+            samples.resize(chunk->size());
+            chunk->copy(0, chunk->size(), samples.data(), 1.f);
+            builder_->add(samples.data(), samples.size() / CHANNELS);
+        }
+    }
+
+    // Created here, so the decoder lives in our (decoder's) thread.
+    decoder_ = new QAudioDecoder(this);
+    decoder_->setAudioFormat(format());
+
+    connect(decoder_, &QAudioDecoder::bufferReady, this, &Track::take);
+    connect(decoder_, &QAudioDecoder::durationChanged, this, [this] (qint64 const duration) {
+        if (duration_ms_ < 0)
+            duration_ms_ = base_frame_ * 1000 / SAMPLE_RATE + duration;
+    });
+    connect(decoder_, &QAudioDecoder::finished, this, [this] {
+        if (writer_)
+            writer_->finish();
+        if (builder_) {
+            auto waveform = builder_->finish();
+            builder_.reset();
+            lock_guard<mutex> lg{mutex_};
+            waveform_ = std::move(waveform);
+        }
+        decoded_ = true;
+    });
+    connect(decoder_, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [this] (auto) {
+        cerr << format("Can't decode {}: {}\n", path_.toStdString(), decoder_->errorString().toStdString()) << flush;
+        builder_.reset();
+        decoded_ = true;
+    });
+
+    if (entry_) {
+        // If it can't be opened the decoder reports the error.
+        auto const device = new Slice(path_, entry_->offset, this);
+        device->open(QIODevice::ReadOnly);
+        decoder_->setSourceDevice(device);
+    }
+    else
+        decoder_->setSource(QUrl::fromLocalFile(path_));
+    decoder_->start();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            t a k e                               *
+ *                                                                  *
+ *******************************************************************/
+
+/// Takes what the decoder has, unless enough is waiting for the reader.
+/// The decoder doesn't decode the next buffer until this one is read,
+/// so it stops too (read() invokes us again when it needs more).
+void Track::take() noexcept {
+    while (decoder_ && decoder_->bufferAvailable()) {
+        {
+            lock_guard<mutex> lg{mutex_};
+            if (buffered_ >= HIGH_WATER) {
+                waiting_ = true;
+                return;
+            }
+        }
+        append(decoder_->read());
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          a p p e n d                             *
+ *                                                                  *
+ *******************************************************************/
+
+void Track::append(QAudioBuffer const& buffer) noexcept {
+    if (!buffer.isValid())
+        return;
+
+    // From the beginning of the file the samples are counted (exact),
+    // from an entry only the timestamps (µs) tell where we are.
+    auto const frames = qint64(buffer.frameCount());
+    auto const first = entry_ ? base_frame_ + buffer.startTime() * SAMPLE_RATE / 1'000'000 : next_frame_;
+    next_frame_ = first + frames;
+    if (first + frames <= decode_frame_)
+        return;
+    auto const skip = std::max<qint64>(0, decode_frame_ - first);
+
+    auto const samples = Track::samples(buffer, skip);
+    if (samples.empty())
+        return;
+    if (builder_)
+        builder_->add(samples.data(), samples.size() / CHANNELS);
+    // The gain is applied when the samples are read.
+    auto chunk = make_shared<PcmCache::Chunk const>(samples.data(), samples.size(), compact_);
+    if (writer_)
+        writer_->add(chunk);
+
+    lock_guard<mutex> lg{mutex_};
+    buffered_ += qint64(chunk->size() / CHANNELS);
+    chunks_.push_back(std::move(chunk));
+}
+
+/********************************************************************
+ *                                                                  *
+ *                         s a m p l e s                            *
+ *                                                                  *
+ *******************************************************************/
+
+vector<float> Track::samples(QAudioBuffer const& buffer, qint64 const skip) noexcept {
+    auto const format = buffer.format();
+    auto const frames = qint64(buffer.frameCount());
+    if (skip >= frames)
+        return {};
+
+    vector<float> samples(size_t(frames - skip) * CHANNELS);
+    if (format.sampleFormat() == QAudioFormat::Float && format.channelCount() == CHANNELS) {
+        auto const data = buffer.constData<float>() + skip * CHANNELS;
+        std::copy_n(data, samples.size(), samples.begin());
+    }
+    else {
+        // The backend didn't give us what we asked for: convert sample by sample
+        // (mono is copied to both channels, channels above two are dropped).
+        auto const data = buffer.constData<char>();
+        auto const frame_bytes = format.bytesPerFrame();
+        auto const sample_bytes = format.bytesPerSample();
+        auto const last_channel = format.channelCount() - 1;
+        for (qint64 i = 0; i < frames - skip; ++i) {
+            auto const frame = data + (skip + i) * frame_bytes;
+            for (int c = 0; c < CHANNELS; ++c)
+                samples[i * CHANNELS + c] = format.normalizedSampleValue(frame + std::min(c, last_channel) * sample_bytes);
+        }
+    }
+
+    return samples;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           r e a d                                *
+ *                                                                  *
+ *******************************************************************/
+
+size_t Track::read(float* const out, size_t const frames) noexcept {
+    auto const wanted = frames * CHANNELS;
+    size_t done{};
+
+    auto const gain = gain_.load();
+
+    lock_guard<mutex> lg{mutex_};
+    while (done < wanted && !chunks_.empty()) {
+        auto const& chunk = *chunks_.front();
+        auto const n = std::min(wanted - done, chunk.size() - offset_);
+        chunk.copy(offset_, n, out + done, gain);
+        done += n;
+        if ((offset_ += n) == chunk.size()) {
+            chunks_.pop_front();
+            offset_ = 0;
+        }
+    }
+    buffered_ -= qint64(done / CHANNELS);
+    // The decoder may go on (in its thread).
+    if (buffered_ < LOW_WATER && waiting_.exchange(false))
+        QMetaObject::invokeMethod(this, &Track::take, Qt::QueuedConnection);
+    frames_ += qint64(done / CHANNELS);
+    return done / CHANNELS;
+}
+
+bool Track::drained() noexcept {
+    if (!decoded_)
+        return {};
+    lock_guard<mutex> lg{mutex_};
+    return chunks_.empty();
+}
@@ -0,0 +1,148 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "seek_index.h"
+#include "waveform.h"
+#include "pcm_cache.h"
+#include <QObject>
+#include <QString>
+#include <QAudioFormat>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <optional>
+#include <utility>
+
+/*------- forward declarations:
+-------------------------------------------------------------------*/
+class QAudioBuffer;
+class QAudioDecoder;
+
+/*------- Track ::QObject:
+-------------------------------------------------------------------*/
+/// One song decoded to interleaved float PCM (see format()).
+/// Decoding runs in the thread the track was moved to (start() must be
+/// invoked there), the samples are taken by the mixer with read().
+/// A track opened at a position drops everything decoded before it;
+/// with an entry from the SeekIndex the decoder starts at that frame
+/// instead of the beginning of the file.
+/// The samples are read already multiplied by the track's gain (ReplayGain).
+/// A track decoded from the beginning builds the song's waveform on the way.
+/// With a lease from the PcmCache the track reads the kept samples first
+/// and the decoder starts only where they end (not at all for a complete
+/// song); the decoder's samples go to the cache only when it decodes
+/// from the beginning of the file (no entry). The decoded samples are kept in the cache's chunks (without
+/// the gain), shared with the cache, so a song is never in memory twice.
+/// The decoder runs ahead of the reader by at most HIGH_WATER frames: above
+/// it the decoded buffer isn't taken (and the decoder waits for that), below
+/// LOW_WATER the reader lets the decoder go on.
+class Track : public QObject {
+    Q_OBJECT
+public:
+    static int const SAMPLE_RATE{44'100};
+    static int const CHANNELS{2};
+    static qint64 const HIGH_WATER{20 * SAMPLE_RATE};
+    static qint64 const LOW_WATER{10 * SAMPLE_RATE};
+    static QAudioFormat format() noexcept;
+    /// Samples of the buffer in format(), without the first 'skip' frames.
+    static std::vector<float> samples(QAudioBuffer const& buffer, qint64 skip = 0) noexcept;
+
+private:
+    QString const path_;
+    qint64 const start_frame_;
+    std::optional<SeekIndex::Point> const entry_;
+    qint64 const base_frame_;               // of the first sample the decoder gives
+    qint64 const decode_frame_;             // the decoder's samples are kept from here
+    std::atomic<float> gain_;
+    bool const cached_whole_;               // nothing to decode
+    std::optional<PcmCache::Writer> writer_{};  // only for the decoder's thread
+    qint64 next_frame_{};                   // without an entry: of the decoder's next sample
+    QAudioDecoder* decoder_{};
+    std::mutex mutex_{};
+    bool const compact_;                    // how the decoded chunks are kept
+    std::deque<PcmCache::ChunkPtr> chunks_{};   // from the cache, then decoded
+    size_t offset_{};                       // samples already read from the front chunk
+    qint64 buffered_{};                     // frames in chunks_ not read yet
+    std::atomic<bool> waiting_{};           // the decoder waits until we take its buffer
+    std::atomic<qint64> frames_{};          // frames already read
+    std::atomic<qint64> duration_ms_{-1};
+    std::atomic<bool> decoded_{};
+    // Only for the decoder's thread, until the waveform is complete.
+    std::optional<Waveform::Builder> builder_{};
+    std::vector<PcmCache::ChunkPtr> prefix_{};  // the song's beginning, from the cache
+    std::optional<Waveform> waveform_{};    // guarded by mutex_
+public:
+    explicit Track(QString path, float gain = 1.f, qint64 start_ms = 0, std::optional<SeekIndex::Point> entry = {},
+                   PcmCache::Lease lease = {});
+    ~Track();
+    Track(Track const&) = delete;
+    Track& operator=(Track const&) = delete;
+
+    QString const& path() const noexcept {
+        return path_;
+    }
+    float gain() const noexcept {
+        return gain_;
+    }
+    /// Heard from the next read on (the gain is applied when reading).
+    void set_gain(float const gain) noexcept {
+        gain_ = gain;
+    }
+    void start() noexcept;
+
+    /// Copies up to 'frames' frames to 'out', returns how many were copied.
+    size_t read(float* out, size_t frames) noexcept;
+    /// Decoding is over and everything was read.
+    bool drained() noexcept;
+
+    qint64 position_ms() const noexcept {
+        return (start_frame_ + frames_) * 1000 / SAMPLE_RATE;
+    }
+    qint64 duration_ms() const noexcept {
+        return duration_ms_;
+    }
+    /// Known before the decoder says it (e.g. the same song before a seek).
+    void set_duration(qint64 const ms) noexcept {
+        duration_ms_ = ms;
+    }
+    /// The complete waveform of the song, once (when it was decoded whole).
+    std::optional<Waveform> take_waveform() noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        return std::exchange(waveform_, std::nullopt);
+    }
+    /// Frames left to the end of the song (if its duration is already known).
+    std::optional<qint64> remaining_frames() const noexcept {
+        if (duration_ms_ < 0)
+            return {};
+        return std::max<qint64>(0, duration_ms_ * SAMPLE_RATE / 1000 - start_frame_ - frames_);
+    }
+private:
+    void take() noexcept;
+    void append(QAudioBuffer const& buffer) noexcept;
+};
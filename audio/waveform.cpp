@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "waveform.h"
+#include <array>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+namespace {
+    int8_t quantize(float const value) noexcept {
+        return int8_t(std::lround(std::clamp(value, -1.f, 1.f) * 127.f));
+    }
+}
+
+Waveform::Builder::Builder(int const channels) :
+    channels_{std::max(1, channels)}
+{}
+
+/********************************************************************
+ *                                                                  *
+ *                            a d d                                 *
+ *                                                                  *
+ *******************************************************************/
+
+void Waveform::Builder::add(float const* samples, size_t frames) noexcept {
+    while (frames) {
+        auto const n = std::min(frames, BUCKET_FRAMES - filled_);
+        reduce(samples, n * size_t(channels_));
+        samples += n * size_t(channels_);
+        frames -= n;
+        if ((filled_ += n) == BUCKET_FRAMES) {
+            buckets_.emplace_back(min_, max_);
+            min_ = NONE;
+            max_ = -NONE;
+            filled_ = 0;
+        }
+    }
+}
+
+/// Min and max of the samples into min_/max_. Every lane keeps its own
+/// min/max (the comparisons are exactly SSE/NEON min/max), the lanes
+/// are merged at the end.
+void Waveform::Builder::reduce(float const* const samples, size_t const count) noexcept {
+    array<float, LANES> lo{}, hi{};
+    lo.fill(min_);
+    hi.fill(max_);
+    size_t i{};
+    for (; i + LANES <= count; i += LANES)
+        for (size_t k = 0; k < LANES; ++k) {
+            auto const x = samples[i + k];
+            lo[k] = x < lo[k] ? x : lo[k];
+            hi[k] = x > hi[k] ? x : hi[k];
+        }
+    auto lowest = *std::ranges::min_element(lo);
+    auto highest = *std::ranges::max_element(hi);
+    for (; i < count; ++i) {
+        lowest = std::min(lowest, samples[i]);
+        highest = std::max(highest, samples[i]);
+    }
+    min_ = lowest;
+    max_ = highest;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          f i n i s h                             *
+ *                                                                  *
+ *******************************************************************/
+
+/// Every point covers an equal share of the buckets (a short song,
+/// with fewer buckets than points, has a point per bucket).
+Waveform Waveform::Builder::finish() noexcept {
+    if (filled_)
+        buckets_.emplace_back(min_, max_);
+    if (buckets_.empty())
+        return {};
+
+    auto const count = std::min(POINTS, buckets_.size());
+    vector<Point> points{};
+    points.reserve(count);
+    for (size_t p = 0; p < count; ++p) {
+        auto const first = p * buckets_.size() / count;
+        auto const last = (p + 1) * buckets_.size() / count;
+        auto lo = buckets_[first].first;
+        auto hi = buckets_[first].second;
+        for (auto b = first + 1; b < last; ++b) {
+            lo = std::min(lo, buckets_[b].first);
+            hi = std::max(hi, buckets_[b].second);
+        }
+        points.push_back({quantize(lo), quantize(hi)});
+    }
+    buckets_.clear();
+    return Waveform{std::move(points)};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           b l o b                                *
+ *                                                                  *
+ *******************************************************************/
+
+vector<uint8_t> Waveform::to_blob() const {
+    vector<uint8_t> blob{};
+    blob.reserve(points_.size() * 2);
+    for (auto const& point : points_) {
+        blob.push_back(uint8_t(point.min));
+        blob.push_back(uint8_t(point.max));
+    }
+    return blob;
+}
+
+Waveform Waveform::from_blob(span<uint8_t const> const blob) {
+    vector<Point> points{};
+    points.reserve(blob.size() / 2);
+    for (size_t i = 0; i + 1 < blob.size(); i += 2)
+        points.push_back({int8_t(blob[i]), int8_t(blob[i + 1])});
+    return Waveform{std::move(points)};
+}
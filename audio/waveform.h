@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <limits>
+
+/*------- Waveform:
+-------------------------------------------------------------------*/
+/// Overview of a song for the progress slider: the lowest and the highest
+/// sample (of all channels) in each of POINTS equal parts of the song,
+/// 8 bits each, so the whole song takes 2 * POINTS bytes.
+class Waveform {
+public:
+    static constexpr size_t POINTS{1000};
+    struct Point {
+        int8_t min{};
+        int8_t max{};
+    };
+
+    /// Collects decoded PCM as it comes: min/max of every BUCKET_FRAMES
+    /// frames (the reduction runs in lanes, so it is vectorized);
+    /// at the end the buckets are merged into POINTS points.
+    class Builder {
+        static constexpr size_t BUCKET_FRAMES{1024};
+        static constexpr size_t LANES{8};
+        static constexpr float NONE{std::numeric_limits<float>::infinity()};
+        int const channels_;
+        std::vector<std::pair<float, float>> buckets_{};
+        float min_{NONE};       // an empty bucket: every sample is below/above
+        float max_{-NONE};
+        size_t filled_{};       // frames in the current bucket
+    public:
+        explicit Builder(int channels);
+        void add(float const* samples, size_t frames) noexcept;
+        Waveform finish() noexcept;
+    private:
+        void reduce(float const* samples, size_t count) noexcept;
+    };
+
+private:
+    std::vector<Point> points_{};
+public:
+    Waveform() = default;
+    explicit Waveform(std::vector<Point> points) : points_{std::move(points)} {}
+
+    bool empty() const noexcept { return points_.empty(); }
+    size_t size() const noexcept { return points_.size(); }
+    /// In -1..1.
+    float min(size_t const i) const noexcept { return float(points_[i].min) / 127.f; }
+    float max(size_t const i) const noexcept { return float(points_[i].max) / 127.f; }
+
+    /// min, max, min, max...
+    std::vector<uint8_t> to_blob() const;
+    static Waveform from_blob(std::span<uint8_t const> blob);
+};
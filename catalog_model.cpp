@@ -0,0 +1,253 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "catalog_model.h"
+#include "model/selection.h"
+#include "model/song_tags.h"
+#include "model/song_fingerprint.h"
+#include <QFont>
+#include <QFileInfo>
+#include <algorithm>
+
+FilesModel::FilesModel(QObject* const parent) : QAbstractTableModel(parent)
+{}
+
+int FilesModel::rowCount(QModelIndex const& parent) const {
+    return parent.isValid() ? 0 : int(names_.size());
+}
+
+int FilesModel::columnCount(QModelIndex const& parent) const {
+    return parent.isValid() ? 0 : 1;
+}
+
+QVariant FilesModel::data(QModelIndex const& index, int const role) const {
+    if (!index.isValid() || index.row() >= int(names_.size()))
+        return {};
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return title(index.row());
+    case Qt::ToolTipRole:
+        return tooltip(index.row());
+    case Qt::FontRole:
+        if (title(index.row()); duplicates_.test(index.row())) {
+            QFont font{};
+            font.setItalic(true);
+            return font;
+        }
+        break;
+    case Qt::CheckStateRole:
+        return checks_.test(index.row()) ? Qt::Checked : Qt::Unchecked;
+    case PATH:
+        return path(index.row());
+    }
+    return {};
+}
+
+QVariant FilesModel::headerData(int const section, Qt::Orientation const orientation, int const role) const {
+    if (role == Qt::DisplayRole && orientation == Qt::Horizontal && section == 0)
+        return QString("Title");
+    return {};
+}
+
+Qt::ItemFlags FilesModel::flags(QModelIndex const& index) const {
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+}
+
+/// Called by the view when the user clicked the check box.
+bool FilesModel::setData(QModelIndex const& index, QVariant const& value, int const role) {
+    if (role != Qt::CheckStateRole || !index.isValid())
+        return {};
+
+    set_checked(index.row(), value.toInt() == Qt::Checked);
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+    emit check_changed();
+    return true;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          r e s e t                               *
+ *                                                                  *
+ *******************************************************************/
+
+void FilesModel::reset(QString dir, std::vector<std::string> const& names) {
+    beginResetModel();
+    dir_ = std::move(dir);
+    names_.clear();
+    names_.reserve(names.size());
+    titles_.clear();
+    titles_.resize(names.size());
+    loaded_ = BitVector(names.size());
+    rows_.clear();
+    duplicates_ = BitVector(names.size());
+    checks_ = BitVector(names.size());
+    for (auto const& name : names) {
+        auto fname = QString::fromStdString(name);
+        if (Selection::self().contains(dir_ + '/' + fname))
+            checks_.set(names_.size(), true);
+        names_.push_back(std::move(fname));
+    }
+    endResetModel();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                 i n s e r t   /   r e m o v e                    *
+ *                                                                  *
+ *******************************************************************/
+
+/// Add a row for the new file (rows are sorted by name).
+bool FilesModel::insert(QString const& path) {
+    if (row_for(path) != -1)
+        return {};
+
+    auto fname = QFileInfo{path}.fileName();
+    auto const it = std::ranges::find_if(names_, [&fname] (QString const& name) {
+        return name.compare(fname, Qt::CaseInsensitive) >= 0;
+    });
+    auto const row = int(it - names_.begin());
+
+    beginInsertRows({}, row, row);
+    names_.insert(it, std::move(fname));
+    titles_.insert(titles_.begin() + row, QString{});
+    loaded_.insert(row, false);
+    rows_.clear();
+    duplicates_.insert(row, false);
+    checks_.insert(row, Selection::self().contains(path));
+    endInsertRows();
+    return true;
+}
+
+/// Remove the row of the file which no longer exists
+/// (a renamed one took its selection with it, see Selection::rename).
+bool FilesModel::remove(QString const& path) {
+    if (auto const row = row_for(path); row != -1) {
+        Selection::self().erase(path);
+        beginRemoveRows({}, row, row);
+        names_.erase(names_.begin() + row);
+        titles_.erase(titles_.begin() + row);
+        loaded_.erase(row);
+        rows_.clear();
+        duplicates_.erase(row);
+        checks_.erase(row);
+        endRemoveRows();
+        return true;
+    }
+    return {};
+}
+
+QString const& FilesModel::title(int const row) const noexcept {
+    auto& title = titles_[row];
+    if (loaded_.set(row, true)) {
+        auto const song = path(row).toStdString();
+        title = SongTags::of(song).title();
+        duplicates_.set(row, !SongFingerprint::duplicates_of(song).empty());
+    }
+    return title;
+}
+
+/// The file name, and where else the recording is (if anywhere).
+QString FilesModel::tooltip(int const row) const {
+    if (title(row); !duplicates_.test(row))
+        return names_[row];
+    auto text = names_[row] + "\n\nThe same recording:";
+    for (auto const& other : SongFingerprint::duplicates_of(path(row).toStdString()))
+        text += "\n" + QString::fromStdString(other);
+    return text;
+}
+
+void FilesModel::refresh(QString const& path) {
+    if (auto const row = row_for(path); row != -1) {
+        loaded_.set(row, false);
+        emit dataChanged(index(row, 0), index(row, 0));
+    }
+}
+
+int FilesModel::row_for(QString const& path) const noexcept {
+    if (!path.startsWith(dir_) || path.size() <= dir_.size() || path[dir_.size()] != '/')
+        return -1;
+    if (rows_.empty() && !names_.empty()) {
+        rows_.reserve(names_.size());
+        for (auto i = 0; i < int(names_.size()); ++i)
+            rows_.emplace(names_[i], i);
+    }
+    if (auto const it = rows_.find(path.mid(dir_.size() + 1)); it != rows_.end())
+        return it->second;
+    return -1;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                       c h e c k i n g                            *
+ *                                                                  *
+ *******************************************************************/
+
+void FilesModel::set_checked(int const row, bool const checked) {
+    if (!checks_.set(row, checked))
+        return;
+    if (checked)
+        Selection::self().insert(path(row));
+    else
+        Selection::self().erase(path(row));
+}
+
+/// Only songs which change their state go to (or out of) the selection
+/// (all of them at once), the bits are set word by word.
+void FilesModel::set_all(bool const checked) {
+    if (names_.empty())
+        return;
+    QStringList paths{};
+    checks_.for_each(!checked, [this, &paths] (size_t const row) {
+        paths << path(row);
+    });
+    if (checked)
+        Selection::self().insert_many(paths);
+    else
+        Selection::self().erase_many(paths);
+    checks_.fill(checked);
+    emit dataChanged(index(0, 0), index(int(names_.size()) - 1, 0), {Qt::CheckStateRole});
+}
+
+void FilesModel::invert() {
+    if (names_.empty())
+        return;
+    QStringList to_erase{};
+    QStringList to_insert{};
+    checks_.for_each(true, [this, &to_erase] (size_t const row) {
+        to_erase << path(row);
+    });
+    checks_.for_each(false, [this, &to_insert] (size_t const row) {
+        to_insert << path(row);
+    });
+    Selection::self().erase_many(to_erase);
+    Selection::self().insert_many(to_insert);
+    checks_.flip();
+    emit dataChanged(index(0, 0), index(int(names_.size()) - 1, 0), {Qt::CheckStateRole});
+}
@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "shared/bit_vector.hh"
+#include <QAbstractTableModel>
+#include <QString>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*------- FilesModel ::QAbstractTableModel:
+-------------------------------------------------------------------*/
+/// Songs of one directory for the FilesTable.
+/// We keep only names of files and their check state (one bit per song),
+/// the view asks only for rows which are visible. Titles (from the tags)
+/// are taken when a row is shown for the first time, together with
+/// the information whether the recording has copies elsewhere
+/// (such songs are shown in italics).
+class FilesModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum {PATH = Qt::UserRole + 1};
+private:
+    QString dir_{};
+    std::vector<QString> names_{};
+    mutable std::vector<QString> titles_{};
+    mutable BitVector loaded_{};                // the title is taken
+    mutable BitVector duplicates_{};            // songs with copies elsewhere (taken with the title)
+    // name -> row, built when it is needed for the first time.
+    mutable std::unordered_map<QString, int> rows_{};
+    BitVector checks_{};
+
+public:
+    explicit FilesModel(QObject* = nullptr);
+
+    int rowCount(QModelIndex const& parent = {}) const override;
+    int columnCount(QModelIndex const& parent = {}) const override;
+    QVariant data(QModelIndex const& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    Qt::ItemFlags flags(QModelIndex const& index) const override;
+    bool setData(QModelIndex const& index, QVariant const& value, int role) override;
+
+    /// New content (names of songs in the directory, sorted).
+    void reset(QString dir, std::vector<std::string> const& names);
+    bool insert(QString const& path);
+    bool remove(QString const& path);
+    int row_for(QString const& path) const noexcept;
+    /// Copies of the song were found, take its data again.
+    void refresh(QString const& path);
+    QString path(int const row) const {
+        return dir_ + '/' + names_[row];
+    }
+
+    void set_all(bool checked);
+    void invert();
+    bool all_checked() const noexcept {
+        return checks_.all();
+    }
+    bool none_checked() const noexcept {
+        return checks_.none();
+    }
+
+signals:
+    /// The user checked/unchecked a song.
+    void check_changed();
+
+private:
+    void set_checked(int row, bool checked);
+    QString const& title(int row) const noexcept;
+    QString tooltip(int row) const;
+};
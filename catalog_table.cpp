@@ -26,55 +26,56 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "model/selection.h"
+#include "model/dir_content.h"
 #include "catalog_table.h"
+#include "catalog_model.h"
 #include "shared/event.hh"
 #include "shared/event_controller.hh"
-#include <QDir>
 #include <QMenu>
 #include <QEvent>
 #include <QAction>
 #include <QFileInfo>
 #include <QMouseEvent>
 #include <QHeaderView>
-#include <QTableWidgetItem>
 #include <QContextMenuEvent>
 #include <fmt/core.h>
 
-FilesTable::FilesTable(QWidget* const parent) : QTableWidget(parent) {
-    setRowCount(0);
-    setColumnCount(1);
+FilesTable::FilesTable(QWidget* const parent) :
+    QTableView(parent),
+    model_{new FilesModel(this)}
+{
+    setModel(model_);
     setEditTriggers(NoEditTriggers);
     setSelectionBehavior(SelectRows);
-    setHorizontalHeaderItem(0, new QTableWidgetItem("Title"));
+    horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    // All rows have the same height, so the view doesn't have to
+    // ask for every row to compute its geometry.
+    verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
     // When user double-clicked the row we play this song (one-shot).
-    connect(this, &QTableWidget::cellDoubleClicked, [&] (auto const row, auto const col){
-        if (auto const selected_item = item(row, 0)) {
-            auto const path = selected_item->data(PATH).toString();
+    connect(this, &QTableView::doubleClicked, [&] (QModelIndex const& index) {
+        if (index.isValid()) {
+            auto const path = model_->path(index.row());
             EventController::self().send(event::SongOneShot, path);
         }
     });
 
     // When user clicked the row it bekome current row.
-    // But important is checking is the row is checked.
-    connect(this, &QTableWidget::itemClicked, this, [this] (QTableWidgetItem* const item) {
-        if (item) {
-            auto checked = item->checkState();
-            auto const path = item->data(PATH).toString();
-            if (checked)
-                Selection::self().insert(path);
-            else
-                Selection::self().erase(path);
-
-            setCurrentItem(item);
-            update_parent();
-        }
+    connect(this, &QTableView::clicked, this, [this] (QModelIndex const& index) {
+        if (index.isValid())
+            setCurrentIndex(index);
+    });
+    // User checked/unchecked the song (the selection is already updated by the model).
+    connect(model_, &FilesModel::check_changed, this, [this] {
+        update_parent();
     });
 
     EventController::self()
         .append(this,
                 event::DirSelected,
-                event::CheckingAllSongs);
+                event::CheckingAllSongs,
+                event::FilesChanged,
+                event::DuplicatesFound);
 }
 
 FilesTable::~FilesTable() {
@@ -89,38 +90,15 @@ void FilesTable::contextMenuEvent(QContextMenuEvent* const event) {
     auto const invert_action = menu->addAction("Invert selection");
 
     connect(check_all_action, &QAction::triggered, this, [this] (auto _) {
-        for (auto i = 0; i < rowCount(); ++i) {
-            auto const it = item(i, 0);
-            if (it->checkState() != Qt::Checked) {
-                it->setCheckState(Qt::Checked);
-                Selection::self().insert(it->data(PATH).toString());
-            }
-        }
+        model_->set_all(true);
         update_parent();
     });
-
     connect(uncheck_all_action, &QAction::triggered, this, [this] (auto _) {
-        for (auto i = 0; i < rowCount(); ++i) {
-            auto const it = item(i, 0);
-            if (it->checkState() != Qt::Unchecked) {
-                it->setCheckState(Qt::Unchecked);
-                Selection::self().erase(it->data(PATH).toString());
-            }
-        }
+        model_->set_all(false);
         update_parent();
     });
     connect(invert_action, &QAction::triggered, this, [this] (auto _) {
-        for (auto i = 0; i < rowCount(); ++i) {
-            auto const it = item(i, 0);
-            if (it->checkState() == Qt::Checked) {
-                it->setCheckState(Qt::Unchecked);
-                Selection::self().erase(it->data(PATH).toString());
-            }
-            else {
-                it->setCheckState(Qt::Checked);
-                Selection::self().insert(it->data(PATH).toString());
-            }
-        }
+        model_->invert();
     });
 
     menu->exec(event->globalPos());
@@ -130,7 +108,7 @@ void FilesTable::contextMenuEvent(QContextMenuEvent* const event) {
 void FilesTable::mousePressEvent(QMouseEvent* const event) {
     if (event->button() == Qt::RightButton)
         return;
-    QTableWidget::mousePressEvent(event);
+    QTableView::mousePressEvent(event);
 }
 
 // Handle my own events.
@@ -143,58 +121,52 @@ void FilesTable::customEvent(QEvent* const event) {
         if (auto const data = e->data(); !data.empty()) {
             auto dir = data[0].toString();
             dir_ = dir;
-            clear_content();
             new_content_for(std::move(dir));
         }
         break;
 
     // Event with a request to check/uncheck ALL items.
     case event::CheckingAllSongs:
-        if (auto const data = e->data(); !data.empty()) {
-            auto const state = data[0].toBool() ? Qt::Checked : Qt::Unchecked;
-            auto const n = rowCount();
-            for (auto i = 0; i < n; ++i) {
-                auto const row = item(i, 0);
-                row->setCheckState(state);
-                if (state == Qt::Checked)
-                    Selection::self().insert(row->data(PATH).toString());
-                else
-                    Selection::self().erase(row->data(PATH).toString());
-            }
+        if (auto const data = e->data(); !data.empty())
+            model_->set_all(data[0].toBool());
+        break;
+
+    // Files were created/removed on the disk.
+    // Only changes in the displayed directory are interesting for us.
+    case event::FilesChanged:
+        if (auto const data = e->data(); data.size() == 2) {
+            auto changed = false;
+            for (auto const& path : data[1].toStringList())
+                if (QFileInfo{path}.path() == dir_)
+                    changed |= model_->remove(path);
+            for (auto const& path : data[0].toStringList())
+                if (QFileInfo const fi{path}; fi.path() == dir_ && is_song(fi.fileName()))
+                    changed |= model_->insert(path);
+            if (changed)
+                update_parent();
+        }
+        break;
+
+    // Copies of a song were found (the song and its copies may be shown).
+    case event::DuplicatesFound:
+        if (auto const data = e->data(); data.size() == 2) {
+            model_->refresh(data[0].toString());
+            for (auto const& path : data[1].toStringList())
+                model_->refresh(path);
         }
         break;
     }
 }
 
-/// New table content (new songs) for new selected directory.
+/// Fill the table with songs of the directory.
+/// The list of songs comes from the cache (if the directory didn't change).
 void FilesTable::new_content_for(QString&& path) {
-    QDir const dir{path};
-    auto const info_list = dir.entryInfoList();
-
-    std::vector<QTableWidgetItem*> data{};
-    data.reserve(info_list.size());
-    for (auto const& fi : info_list) {
-        if (!fi.isDir() && fi.isFile()) {
-            auto const fname = fi.fileName();
-            if (fname[0] !='.' && (fname.endsWith(".m4a") || fname.endsWith(".mp3"))) {
-                auto item = new QTableWidgetItem(fname);
-                auto const path = fi.filePath();
-                if (Selection::self().contains(path))
-                    item->setCheckState(Qt::Checked);
-                else
-                    item->setCheckState(Qt::Unchecked);
-                item->setData(PATH, path);
-                data.push_back(item);
-            }
-        }
-    }
+    auto const files = DirContent::songs_in(path.toStdString());
+    model_->reset(std::move(path), files);
+}
 
-    int row = 0;
-    setRowCount(data.size());
-    std::ranges::for_each(data, [&] (auto item) {
-        setItem(row++, 0, item);
-    });
-    horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+bool FilesTable::is_song(QString const& fname) noexcept {
+    return DirContent::is_song(fname.toStdString());
 }
 
 void FilesTable::update_parent() const noexcept {
@@ -207,18 +179,9 @@ void FilesTable::update_parent() const noexcept {
 }
 
 bool FilesTable::are_all_checked() const noexcept {
-    auto const n = rowCount();
-    for (auto i = 0; i < n; ++i)
-        if (item(i, 0)->checkState() != Qt::Checked)
-            return false;
-    return true;
+    return model_->all_checked();
 }
 
 bool FilesTable::are_all_unchecked() const noexcept {
-    auto const n = rowCount();
-    for (auto i = 0; i < n; ++i)
-        if (item(i, 0)->checkState() != Qt::Unchecked)
-            return false;
-    return true;
+    return model_->none_checked();
 }
-
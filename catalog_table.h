@@ -27,19 +27,20 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
-#include <QTableWidget>
+#include <QTableView>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
 class QEvent;
+class FilesModel;
 class QMouseEvent;
 class QContextMenuEvent;
 
 
-class FilesTable : public QTableWidget {
+class FilesTable : public QTableView {
     Q_OBJECT
-    enum {PATH = Qt::UserRole + 1};
     QString dir_{};
+    FilesModel* const model_;
 public:
     FilesTable(QWidget* = nullptr);
     ~FilesTable();
@@ -49,12 +50,9 @@ private:
     void customEvent(QEvent*) override;
     void new_content_for(QString&& path);
 
-    void clear_content() noexcept {
-        clearContents();
-        setRowCount(0);
-    }
-
     void update_parent() const noexcept;
     bool are_all_checked() const noexcept;
     bool are_all_unchecked() const noexcept;
+
+    static bool is_song(QString const& fname) noexcept;
 };
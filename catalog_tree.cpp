@@ -26,6 +26,12 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "catalog_tree.h"
+#include "model/library_index.h"
+#include "model/dir_content.h"
+#include "model/song.h"
+#include "model/selection.h"
+#include "audio/fingerprinter.h"
+#include "tool.h"
 #include "shared/event.hh"
 #include "shared/event_controller.hh"
 #include <QDir>
@@ -33,12 +39,27 @@
 #include <QFileInfo>
 #include <QHeaderView>
 #include <QTreeWidgetItem>
-#include <QTreeWidgetItemIterator>
 #include <fmt/core.h>
 
 DirsTree::DirsTree(QWidget* const parent) :
     QTreeWidget(parent),
-    timer_{new QTimer}
+    timer_{new QTimer},
+    fingerprinter_{new Fingerprinter(this)},
+    watcher_{[] (DirWatcher::Changes&& changes) {
+        // Called on the watcher thread.
+        LibraryIndex::self().apply(changes.created_dirs, changes.removed_dirs);
+        if (!changes.created_dirs.empty() || !changes.removed_dirs.empty())
+            EventController::self().send(event::DirsChanged,
+                tool::to_qstringlist(std::move(changes.created_dirs)),
+                tool::to_qstringlist(std::move(changes.removed_dirs)));
+        // Before the tables see the old path removed.
+        for (auto const& [from, to] : changes.moved_files)
+            Selection::self().rename(QString::fromStdString(from), QString::fromStdString(to));
+        if (!changes.created_files.empty() || !changes.removed_files.empty())
+            EventController::self().send(event::FilesChanged,
+                tool::to_qstringlist(std::move(changes.created_files)),
+                tool::to_qstringlist(std::move(changes.removed_files)));
+    }}
 {
     // !!! Timer configuration !!!
     // The timer is the sender of an event with information
@@ -75,17 +96,24 @@ DirsTree::DirsTree(QWidget* const parent) :
         setCurrentItem(item);
         emit currentItemChanged(item, item);
     });
-
-    update_content("/home/piotr/Music");
-    setCurrentItem(root_);
+    // Children of the directory are created when it is expanded for the first time.
+    connect(this, &QTreeWidget::itemExpanded, this, [this] (auto item) {
+        populate(item);
+    });
 
     EventController::self().append(this,
         event::AllSongsSelected,
         event::NoSongsSelected,
-        event::PartlySongsSelected);
+        event::PartlySongsSelected,
+        event::DirsChanged);
+
+    update_content("/home/piotr/Music");
+    setCurrentItem(root_);
 }
 
 DirsTree::~DirsTree() {
+    tag_scanner_.cancel();
+    scanner_.cancel();
     EventController::self().remove(this);
 }
 
@@ -108,71 +136,181 @@ void DirsTree::customEvent(QEvent* const event) {
             if (auto const item = item_for(data[0].toString()))
                 item->setCheckState(0, Qt::PartiallyChecked);
         break;
+    // Directories were created/removed on the disk.
+    case event::DirsChanged:
+        if (auto const data = e->data(); data.size() == 2) {
+            for (auto const& path : data[1].toStringList())
+                if (auto const item = item_for(QString{path}); item && item != root_) {
+                    auto const parent = item->parent();
+                    remove_item(item);
+                    if (parent->childCount() == 0)
+                        parent->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+                }
+            for (auto const& path : data[0].toStringList())
+                add_dir(path);
+        }
+        break;
     }
 }
 
+/// Fill the tree with directories located under the passed path.
+/// Only the first level is created here, deeper levels are created
+/// on demand (when the user expands the directory).
+/// In the meantime the whole library is read in background into
+/// the index (without creating any tree items) and tags of all songs
+/// are brought into the cache. Then songs of playlists whose files
+/// were moved are found again (by the content hash) and songs get
+/// their fingerprints (to find copies of the same recording).
 void DirsTree::update_content(QString const& path) {
     clear();
+    items_.clear();
+    next_id_ = 0;
+
     root_ = new QTreeWidgetItem(this);
     root_->setText(0, "Performer");
-    root_->setData(0, ID, 0);
+    root_->setData(0, ID, next_id_);
     root_->setData(0, PID, -1);
     root_->setData(0, PATH, path);
+    items_.emplace(path, root_);
 
-    add_items_for(root_);
-    update_if_checkable();
+    // Every directory read by the scanner is watched for changes,
+    // song files it finds go to the tag scanner.
+    scanner_.cancel();
+    watcher_.clear();
+    LibraryIndex::self().clear();
+    tag_scanner_.start([fingerprinter = fingerprinter_] (TagScanner::Progress const& progress) {
+        if (progress.finished) {
+            if (auto const relinked = Song::relink())
+                EventController::self().send(event::SongsRelinked, qulonglong(relinked));
+            fingerprinter->start();
+        }
+        EventController::self().send(progress.finished ? event::TagScanFinished : event::TagScanProgress,
+            qulonglong(progress.done),
+            qulonglong(progress.found),
+            progress.files_per_second());
+    });
+    scanner_.start(path.toStdString(),
+        [this] (uint, DirScanner::Batch&& batch) {
+            for (auto const& listing : batch)
+                watcher_.watch(listing);
+            tag_scanner_.add(batch);
+            LibraryIndex::self().add(std::move(batch));
+        },
+        [this] (uint) { tag_scanner_.close(); },
+        DirContent::is_song);
+
+    populate(root_);
     root_->setExpanded(true);
 }
 
-auto DirsTree::
-add_items_for(QTreeWidgetItem* const parent)
--> void {
-    auto parent_path = parent->data(0, PATH).toString();
-    QDir const dir{parent_path};
-    auto const content = dir.entryInfoList();
-
-    int const pid = parent->data(0, ID).toInt();
-    int did = pid;
-    for (auto const& fi : content) {
-        if (fi.isDir()) {
-            auto const fname = fi.fileName();
-            if (fname[0] !='.') {
-                auto const item = new QTreeWidgetItem(parent);
-                item->setText(0, fname);
-                if (pid != 0)
-                    item->setCheckState(0, Qt::Unchecked);
-                item->setData(0, PATH, fi.filePath());
-                item->setData(0, PID, pid);
-                item->setData(0, ID, ++did);
-                add_items_for(item);
-            }
-        }
+/// Create children of the item (only once).
+/// We take subdirectories from the index, if the scanner hasn't
+/// reached the directory yet we read it ourselves.
+/// For every child we only check if it has any subdirectories
+/// (to show the expand indicator), its content is not read.
+void DirsTree::populate(QTreeWidgetItem* const parent) {
+    if (parent->data(0, POPULATED).toBool())
+        return;
+    parent->setData(0, POPULATED, true);
+
+    auto const parent_path = parent->data(0, PATH).toString().toStdString();
+    auto subdirs = LibraryIndex::self().subdirs(parent_path);
+    if (!subdirs) {
+        auto listing = DirScanner::list(parent_path);
+        subdirs = listing.subdirs;
+        LibraryIndex::self().add(std::move(listing));
     }
+
+    QStringList names{};
+    names.reserve(subdirs->size());
+    std::ranges::for_each(*subdirs, [&names] (auto const& name) {
+        names << QString::fromStdString(name);
+    });
+    std::ranges::sort(names, [] (QString const& a, QString const& b) {
+        return a.compare(b, Qt::CaseInsensitive) < 0;
+    });
+
+    for (auto const& name : names)
+        setup_child(add_item(parent, name));
+    if (parent->childCount() == 0)
+        parent->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
 }
 
+/// Check if the new item has subdirectories (expand indicator)
+/// and if it should be checkable.
+void DirsTree::setup_child(QTreeWidgetItem* const item) {
+    auto const path = item->data(0, PATH).toString().toStdString();
+    auto has_children = LibraryIndex::self().has_subdirs(path);
+    if (!has_children)
+        has_children = DirScanner::has_subdirs(path);
+    if (*has_children)
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    // Performers (first level) are checkable only if they have no albums.
+    if (item->parent() != root_ || !*has_children)
+        item->setCheckState(0, Qt::Unchecked);
+}
+
+/// Children are kept sorted by name (case insensitive).
 auto DirsTree::
-item_for(QString&& path) const
+add_item(QTreeWidgetItem* const parent, QString const& name)
 -> QTreeWidgetItem* {
-    QTreeWidgetItemIterator it(root_);
-    while (*it) {
-        QTreeWidgetItem* const item = *it;
-        if (item->data(0, PATH).toString() == path)
-            return item;
-        ++it;
+    auto const path = parent->data(0, PATH).toString() + '/' + name;
+    auto const item = new QTreeWidgetItem;
+    item->setText(0, name);
+    item->setData(0, PATH, path);
+    item->setData(0, PID, parent->data(0, ID));
+    item->setData(0, ID, ++next_id_);
+
+    auto first = 0;
+    auto last = parent->childCount();
+    while (first < last) {
+        auto const middle = (first + last) / 2;
+        if (parent->child(middle)->text(0).compare(name, Qt::CaseInsensitive) < 0)
+            first = middle + 1;
+        else
+            last = middle;
     }
-    return {};
+    parent->insertChild(first, item);
+    items_.emplace(path, item);
+    return item;
 }
 
-void DirsTree::update_if_checkable() const noexcept {
-    if (root_) {
-        auto const n = root_->childCount();
-        if (n > 0) {
-            for (auto i = 0; i < n; ++i) {
-                auto const item = root_->child(i);
-                if (0 == item->childCount())
-                    // if item don't have childs is self checkable,
-                    item->setCheckState(0, Qt::Unchecked);
-            }
-        }
+/// The directory was created on the disk.
+/// If the content of its parent is already shown we add it,
+/// otherwise it will be read when the parent is expanded.
+void DirsTree::add_dir(QString const& path) {
+    auto const idx = path.lastIndexOf('/');
+    auto const parent = item_for(path.left(idx));
+    if (!parent || item_for(QString{path}))
+        return;
+
+    if (!parent->data(0, POPULATED).toBool()) {
+        parent->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        return;
     }
+    // The performer got an album, so it is no longer checkable.
+    if (parent->parent() == root_)
+        parent->setData(0, Qt::CheckStateRole, QVariant{});
+    setup_child(add_item(parent, path.mid(idx + 1)));
+}
+
+/// Remove the item (with all its descendants) from the tree and from the index.
+void DirsTree::remove_item(QTreeWidgetItem* const item) {
+    std::vector<QTreeWidgetItem*> stack{item};
+    while (!stack.empty()) {
+        auto const it = stack.back();
+        stack.pop_back();
+        items_.erase(it->data(0, PATH).toString());
+        for (auto i = 0; i < it->childCount(); ++i)
+            stack.push_back(it->child(i));
+    }
+    delete item;
+}
+
+auto DirsTree::
+item_for(QString&& path) const
+-> QTreeWidgetItem* {
+    if (auto const it = items_.find(path); it != items_.end())
+        return it->second;
+    return {};
 }
@@ -26,8 +26,12 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
+#include "library/dir_scanner.h"
+#include "library/dir_watcher.h"
+#include "library/tag_scanner.h"
 #include <QTreeWidget>
 #include <unordered_set>
+#include <unordered_map>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
@@ -36,14 +40,23 @@ class QEvent;
 class QShowEvent;
 class QMouseEvent;
 class QTreeWidgetItem;
+class Fingerprinter;
 
 
 class DirsTree : public QTreeWidget {
     Q_OBJECT
-    enum {ID = Qt::UserRole + 1, PID, PATH};
+    enum {ID = Qt::UserRole + 1, PID, PATH, POPULATED};
     QTreeWidgetItem* root_{};
     QTimer* const timer_;
     std::unordered_set<QString> selections_{};
+    // Index of created items (path -> item).
+    // Every item has to be added here when created and removed when deleted.
+    std::unordered_map<QString, QTreeWidgetItem*> items_{};
+    DirScanner scanner_{};
+    TagScanner tag_scanner_{};
+    Fingerprinter* const fingerprinter_;    // when the tags are in the cache
+    DirWatcher watcher_;
+    int next_id_{};
 
 public:
     DirsTree(QWidget* = nullptr);
@@ -52,7 +65,10 @@ public:
 private:
     void customEvent(QEvent*) override;
     void update_content(QString const& path);
-    auto add_items_for(QTreeWidgetItem* parent) -> void;
+    void populate(QTreeWidgetItem* parent);
+    QTreeWidgetItem* add_item(QTreeWidgetItem* parent, QString const& name);
+    void add_dir(QString const& path);
+    void setup_child(QTreeWidgetItem* item);
+    void remove_item(QTreeWidgetItem* item);
     QTreeWidgetItem* item_for(QString&& path) const;
-    void update_if_checkable() const noexcept;
 };
@@ -30,36 +30,63 @@
 #include "shared/event_controller.hh"
 #include "model/selection.h"
 #include "model/song.h"
+#include "model/song_tags.h"
+#include "model/song_loudness.h"
+#include "model/song_waveform.h"
 #include "tool.h"
-#include <QUrl>
-#include <QDir>
+#include "audio/engine.h"
+#include "audio/loudness_analyzer.h"
 #include <QIcon>
 #include <QLabel>
 #include <QEvent>
 #include <QSlider>
 #include <QStyle>
 #include <QFileInfo>
+#include <QMenu>
+#include <QAction>
+#include <QActionGroup>
 #include <QPushButton>
 #include <QHBoxLayout>
-#include <QMediaPlayer>
-#include <QAudioOutput>
-#include <span>
 #include <iostream>
 #include <format>
 
 
 using namespace std;
 
+namespace {
+    // The waveform travels in the event as its blob.
+    QByteArray to_bytes(Waveform const& waveform) {
+        auto const blob = waveform.to_blob();
+        return QByteArray(reinterpret_cast<char const*>(blob.data()), qsizetype(blob.size()));
+    }
+
+    // Equalizer presets, gains (dB) from 31 Hz to 16 kHz.
+    struct Preset {
+        char const* name;
+        Equalizer::Gains gains;
+    };
+    constexpr Preset EQ_PRESETS[] {
+        {"flat",       { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0}},
+        {"bass",       { 6,  5,  3,  1,  0,  0,  0,  0,  0,  0}},
+        {"treble",     { 0,  0,  0,  0,  0,  0,  1,  3,  5,  6}},
+        {"loudness",   { 5,  4,  2,  0, -1,  0,  0,  1,  3,  4}},
+        {"vocal",      {-2, -2, -1,  0,  2,  3,  3,  2,  0, -1}},
+        {"small room", { 0,  0, -2, -3, -1,  0,  0,  0,  0,  0}},
+    };
+}
+
 ControlBar::ControlBar(QWidget* const parent)
     : QWidget{parent}
-    , player_{new QMediaPlayer}
-    , audio_output_{new QAudioOutput}
+    , engine_{new Engine(this, Engine::Config{})}
+    , analyzer_{new LoudnessAnalyzer(this)}
     , play_icon_{style()->standardIcon(QStyle::SP_MediaPlay)}
     , pause_icon_{style()->standardIcon(QStyle::SP_MediaPause)}
     , volume_icon_{style()->standardIcon(QStyle::SP_MediaVolume)}
     , volume_muted_icon_{style()->standardIcon(QStyle::SP_MediaVolumeMuted)}
     , volume_btn_{new QPushButton}
     , play_pause_btn_{new QPushButton()}
+    , crossfade_btn_{new QPushButton()}
+    , eq_btn_{new QPushButton()}
     , sound_slide_{new QSlider(Qt::Horizontal)}
     , performer_{new QLabel}
     , album_{new QLabel}
@@ -75,44 +102,55 @@ ControlBar::ControlBar(QWidget* const parent)
     sound_slide_->setTickPosition(QSlider::TicksBothSides);
     sound_slide_->setToolTipDuration(DEFAULT_TIP_DURATION);
     connect(sound_slide_, &QSlider::sliderMoved, this, [this] (int const position) {
-        audio_output_->setVolume(position/100.);
+        engine_->set_volume(position/100.f);
     });
 
-    // audio (player & output) settings -----------------------------
-    player_->setAudioOutput(audio_output_);
+    // audio engine settings ----------------------------------------
     // The playback position changed while the song was playing.
     // Information for the playback progress slider.
-    connect(player_, &QMediaPlayer::positionChanged, this, [this](auto pos) {
+    connect(engine_, &Engine::position_changed, this, [this](auto pos) {
         if (pos != previous_position_) {
             EventController::self().send(event::SongProgress, pos);
             previous_position_ = pos;
         }
+        if (previous_duration_ > 0 && previous_duration_ - pos <= PRELOAD_AHEAD_MS + engine_->crossfade())
+            preload_next();
     });
     // Information about the duration of the song.
     // Information for the playback progress slider (slider scaling).
-    connect(player_, &QMediaPlayer::durationChanged, this, [this](auto pos) {
+    connect(engine_, &Engine::duration_changed, this, [this](auto pos) {
         if (pos != previous_duration_) {
             EventController::self().send(event::SongRange, pos);
             previous_duration_ = pos;
         }
     });
-    // The song has finished playing.
-    connect(player_, &QMediaPlayer::mediaStatusChanged, this, [this](auto status) {
-        switch (status) {
-        case QMediaPlayer::EndOfMedia:
-            play_next();
-            break;
-        default:
-        {}
-        }
+    // The engine went on to the enqueued song by itself.
+    connect(engine_, &Engine::track_started, this, [this](auto const& path) {
+        song_started(path);
     });
-
-    // Controller button settings -----------------------------------
-    connect(audio_output_, &QAudioOutput::volumeChanged, this, [this] (double volume) {
-        sound_slide_->setValue(100. * volume);
+    // A song was decoded whole for the first time: its waveform is kept
+    // and shown at once if the song is playing.
+    connect(engine_, &Engine::waveform_ready, this, [this](auto const& path, auto const& waveform) {
+        SongWaveform::save(path.toStdString(), waveform);
+        if (path == song_path_)
+            EventController::self().send(event::SongWaveform, to_bytes(waveform));
+    });
+    // The album was measured: the playing (and the enqueued) song get their gain now.
+    connect(analyzer_, &LoudnessAnalyzer::analyzed, this, [this](auto const& album) {
+        lock_guard<mutex> lg{mutex_};
+        if (!song_path_.isEmpty() && QFileInfo(song_path_).path() == album)
+            engine_->set_gain(song_path_, gain(song_path_, idx_));
+        if (auto const next = engine_->enqueued(); !next.isEmpty() && QFileInfo(next).path() == album)
+            engine_->set_gain(next, gain(next, song_idx(next)));
+    });
+    // The song has finished playing and nothing was enqueued.
+    connect(engine_, &Engine::finished, this, [this] {
+        play_next();
     });
 
-    audio_output_->setVolume(DEFAULT_VOLUME/100.);
+    // Controller button settings -----------------------------------
+    sound_slide_->setValue(DEFAULT_VOLUME);
+    engine_->set_volume(DEFAULT_VOLUME/100.f);
 
     // volume button/icon settings
     volume_btn_->setFlat(true);
@@ -129,9 +167,46 @@ ControlBar::ControlBar(QWidget* const parent)
             volume_btn_->setToolTip(AUDIBLE_TIP);
             sound_slide_->setEnabled(true);
         }
-        audio_output_->setMuted(muted_);
+        engine_->set_muted(muted_);
     });
 
+    // crossfade button/menu settings
+    crossfade_btn_->setFlat(true);
+    crossfade_btn_->setToolTip(CROSSFADE_TIP);
+    crossfade_btn_->setToolTipDuration(DEFAULT_TIP_DURATION);
+    auto const crossfade_menu = new QMenu(crossfade_btn_);
+    auto const crossfade_group = new QActionGroup(crossfade_menu);
+    for (qint64 const seconds : {0, 2, 4, 6, 8, 10}) {
+        auto const action = crossfade_menu->addAction(seconds ? QString("crossfade %1 s").arg(seconds) : QString("gapless"));
+        action->setCheckable(true);
+        action->setChecked(!seconds);
+        crossfade_group->addAction(action);
+        connect(action, &QAction::triggered, this, [this, seconds] {
+            set_crossfade(seconds * 1000);
+        });
+    }
+    crossfade_btn_->setMenu(crossfade_menu);
+    set_crossfade(0);
+
+    // equalizer button/menu settings
+    eq_btn_->setFlat(true);
+    eq_btn_->setToolTip(EQ_TIP);
+    eq_btn_->setToolTipDuration(DEFAULT_TIP_DURATION);
+    eq_btn_->setText(EQ_PRESETS[0].name);
+    auto const eq_menu = new QMenu(eq_btn_);
+    auto const eq_group = new QActionGroup(eq_menu);
+    for (auto const& preset : EQ_PRESETS) {
+        auto const action = eq_menu->addAction(preset.name);
+        action->setCheckable(true);
+        action->setChecked(&preset == EQ_PRESETS);
+        eq_group->addAction(action);
+        connect(action, &QAction::triggered, this, [this, &preset] {
+            engine_->set_equalizer(preset.gains);
+            eq_btn_->setText(preset.name);
+        });
+    }
+    eq_btn_->setMenu(eq_menu);
+
     // play/pause button/pause settings
     play_pause_btn_->setFlat(true);
     play_pause_btn_->setIcon(play_icon_);
@@ -179,6 +254,8 @@ ControlBar::ControlBar(QWidget* const parent)
     layout->addStretch();
     layout->addWidget(volume_btn_);
     layout->addWidget(sound_slide_);
+    layout->addWidget(crossfade_btn_);
+    layout->addWidget(eq_btn_);
     layout->addSpacing(10);
     layout->addLayout(play_layout);
     layout->setContentsMargins(0, 0, 0, 0);
@@ -197,6 +274,104 @@ ControlBar::~ControlBar() {
     EventController::self().remove(this);
 }
 
+/********************************************************************
+ *                                                                  *
+ *                    p r e l o a d _ n e x t                       *
+ *                                                                  *
+ *******************************************************************/
+
+void ControlBar::preload_next() noexcept {
+    lock_guard<mutex> lg{mutex_};
+
+    // The same song that play_next would choose.
+    auto idx = -1;
+    if (saved_idx_ > -1 && saved_idx_ < songs_.size())
+        idx = saved_idx_;
+    else if (idx_ > -1 && (idx_ + 1) < songs_.size())
+        idx = idx_ + 1;
+
+    // The engine starts decoding it now and takes it over
+    // when the current one ends (or crossfades into it).
+    if (idx > -1)
+        engine_->enqueue(songs_[idx], gain(songs_[idx], idx));
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        p r e f e t c h                           *
+ *                                                                  *
+ *******************************************************************/
+
+// mutex_ must be locked.
+void ControlBar::prefetch() noexcept {
+    // The songs play_next will choose, in that order.
+    vector<string> paths{};
+    paths.reserve(Prefetcher::LOOKAHEAD);
+    auto const first = saved_idx_ > -1 ? saved_idx_ : idx_ + 1;
+    for (auto i = std::max(0, first); i < songs_.size() && paths.size() < Prefetcher::LOOKAHEAD; ++i) {
+        paths.push_back(songs_[i].toStdString());
+        // Their loudness will be needed soon too.
+        analyzer_->analyze(QFileInfo(songs_[i]).path());
+    }
+    prefetcher_.prefetch(std::move(paths));
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            g a i n                               *
+ *                                                                  *
+ *******************************************************************/
+
+/// ReplayGain of the song: the album gain while its album is played in order
+/// (a neighbour in the list is from the same directory), the track gain otherwise.
+/// Not measured yet - no gain (and the album is queued for measuring).
+float ControlBar::gain(QString const& path, int const idx) const noexcept {
+    auto const album = QFileInfo(path).path();
+    auto const loudness = SongLoudness::for_path(path.toStdString());
+    if (!loudness) {
+        analyzer_->analyze(album);
+        return 1.f;
+    }
+    auto const same_album = [&] (int const i) {
+        return i > -1 && i < songs_.size() && QFileInfo(songs_[i]).path() == album;
+    };
+    if (idx > -1 && (same_album(idx - 1) || same_album(idx + 1)))
+        return loudness->album_gain();
+    return loudness->track_gain();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                    s o n g _ s t a r t e d                       *
+ *                                                                  *
+ *******************************************************************/
+
+void ControlBar::song_started(QString const& path) noexcept {
+    {
+        lock_guard<mutex> lg{mutex_};
+        // The same step as in play_next, only the engine made it.
+        if (auto const idx = song_idx(path); idx != -1) {
+            idx_ = idx;
+            saved_idx_ = -1;
+        }
+        prefetch();
+    }
+    show_song(path);
+    song_path_ = path;
+    EventController::self().send(event::SongPlayed, path);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                   s e t _ c r o s s f a d e                      *
+ *                                                                  *
+ *******************************************************************/
+
+void ControlBar::set_crossfade(qint64 const ms) noexcept {
+    engine_->set_crossfade(ms);
+    crossfade_btn_->setText(ms ? QString("%1 s").arg(ms / 1000) : QString("gapless"));
+}
+
 /********************************************************************
  *                                                                  *
  *                      s h o w E v e n t                           *
@@ -251,14 +426,15 @@ void ControlBar::customEvent(QEvent* const event) {
         if (auto const data = e->data(); !data.empty()) {
             auto const position = data[0].toULongLong();
             if (played_)
-                player_->setPosition(position);
+                engine_->seek(position);
         }
         break;
     // User would like to start play selections.
     case event::StartSelectedPlayback: {
             lock_guard<mutex> lg{mutex_};
-            if (!Selection::self().empty()) {
-                songs_ = Selection::self().to_list();
+            if (auto const snapshot = Selection::self().snapshot(); !snapshot->paths.isEmpty()) {
+                songs_ = snapshot->paths;
+                selection_version_ = snapshot->version;
                 set_song(songs_[idx_ = 0]);
             }
         }
@@ -267,6 +443,7 @@ void ControlBar::customEvent(QEvent* const event) {
         case event::StartPlaylistPlayback: {
             lock_guard<mutex> lg{mutex_};
             songs_.clear();
+            selection_version_.reset();
             if (auto const data = e->data(); !data.empty()) {
                 auto const playlist_id = data[0].toUInt();
                 auto const playlist_songs = Song::all_for(playlist_id);
@@ -280,8 +457,15 @@ void ControlBar::customEvent(QEvent* const event) {
         }
         break;
     case event::SelectionChanged: {
+            // Several changes may be announced before we get here,
+            // the songs are taken once for all of them.
+            auto const snapshot = Selection::self().snapshot();
             lock_guard<mutex> lg{mutex_};
-            songs_ = Selection::self().to_list();
+            if (selection_version_ != snapshot->version) {
+                songs_ = snapshot->paths;
+                selection_version_ = snapshot->version;
+                prefetch();
+            }
         }
         break;
     }
@@ -333,48 +517,49 @@ void ControlBar::play_prev() noexcept {
  *******************************************************************/
 
 void ControlBar::set_song(QString const& path) noexcept {
-    auto items = path.split(QDir::separator());
-    if (items.size() < 4)
-        return;
+    show_song(path);
 
-    std::vector<QString> data{};
-    data.reserve(items.size());
-    std::ranges::for_each(items, [&data] (auto&& item) {
-        data.push_back(std::move(item));
-    });
-    std::span<QString> span{data};
+    // Set player.
+    song_path_ = path;
+    auto const idx = (idx_ > -1 && idx_ < songs_.size() && songs_[idx_] == path) ? idx_ : -1;
+    engine_->play(path, gain(path, idx));
+    prefetch();
+    played_ = true;
+    playback_changed();
+    EventController::self().send(event::SongPlayed, path);
+}
 
-    auto title = span.last(1)[0];
-    if (auto idx = title.lastIndexOf('.'); idx != -1)
-        title = title.chopped(title.size() - idx);
+/// Title, album and performer from the tags of the song
+/// (or from its path, if it has no tags).
+void ControlBar::show_song(QString const& path) noexcept {
+    auto const tags = SongTags::of(path.toStdString());
     title_->setText(QString("Title: <b><font color=#ffc66d>%1</font></b>")
-                        .arg(title));
-
-    span = span.subspan(0, span.size() - 1);
+                        .arg(tags.title()));
     album_->setText(QString("Album: <b><font color=#5aab73>%1</font></b>")
-                        .arg(span.last(1)[0]));
-    span = span.subspan(0, span.size() - 1);
+                        .arg(tags.album()));
     performer_->setText(QString("Performer: <b><font color=#2aacb8>%1</font></b>")
-                            .arg(span.last(1)[0]));
+                            .arg(tags.artist()));
     title_->setToolTip(path);
 
-    // Set player.
-    song_path_ = path;
-    player_->setSource(QUrl::fromLocalFile(path));
-    player_->play();
-    played_ = true;
-    playback_changed();
-    EventController::self().send(event::SongPlayed, path);
+    // The duration from the headers, the slider is ready before decoding starts
+    // (the decoder's duration, if different, comes later).
+    if (auto const duration = tags.duration_ms(); duration > 0 && duration != previous_duration_) {
+        EventController::self().send(event::SongRange, qint64(duration));
+        previous_duration_ = duration;
+    }
+    // The waveform from the cache, or none until the song is decoded whole.
+    auto const waveform = SongWaveform::for_path(path.toStdString());
+    EventController::self().send(event::SongWaveform, waveform ? to_bytes(*waveform) : QByteArray{});
 }
 
 void ControlBar::playback_changed() const noexcept {
     if (played_) {
         play_pause_btn_->setIcon(pause_icon_);
         play_pause_btn_->setToolTip(PAUSE_TIP);
-        player_->play();
+        engine_->set_paused(false);
         return;
     }
     play_pause_btn_->setIcon(play_icon_);
     play_pause_btn_->setToolTip(PLAY_TIP);
-    player_->pause();
+    engine_->set_paused(true);
 }
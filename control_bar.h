@@ -26,10 +26,12 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
+#include "library/prefetcher.h"
 #include <QWidget>
 #include <QIcon>
 #include <QStringList>
 #include <mutex>
+#include <optional>
 
 /*------- forward eclarations:
 -------------------------------------------------------------------*/
@@ -38,8 +40,8 @@ class QSlider;
 class QEvent;
 class QShowEvent;
 class QPushButton;
-class QMediaPlayer;
-class QAudioOutput;
+class Engine;
+class LoudnessAnalyzer;
 
 /*------- ControlBar ::QWidget:
 -------------------------------------------------------------------*/
@@ -50,17 +52,24 @@ class ControlBar : public QWidget {
     static inline QString const PAUSE_TIP{"pause"};
     static inline QString const AUDIBLE_TIP{"audible"};
     static inline QString const MUTE_TIP{"mute"};
+    static inline QString const CROSSFADE_TIP{"transition between songs"};
+    static inline QString const EQ_TIP{"equalizer"};
     static int const DEFAULT_TIP_DURATION{2000};
     static int const DEFAULT_VOLUME{40};
+    // How long before the end of the song (and its crossfade) the next one is opened.
+    static qint64 const PRELOAD_AHEAD_MS{10'000};
 
-    QMediaPlayer* const player_;
-    QAudioOutput* const audio_output_;
+    Engine* const engine_;
+    LoudnessAnalyzer* const analyzer_;  // ReplayGain of the albums being played
+    Prefetcher prefetcher_{};   // the next songs go to the page cache
     QIcon play_icon_;
     QIcon pause_icon_;
     QIcon volume_icon_;
     QIcon volume_muted_icon_;
     QPushButton* const volume_btn_;
     QPushButton* const play_pause_btn_;
+    QPushButton* const crossfade_btn_;
+    QPushButton* const eq_btn_;
     QSlider* const sound_slide_;
     QLabel* const performer_;
     QLabel* const album_;
@@ -71,6 +80,8 @@ class ControlBar : public QWidget {
     bool one_shot_{};
     QString song_path_{};
     QStringList songs_{};
+    // Version of the selection the songs_ were taken from (none for a playlist).
+    std::optional<uint64_t> selection_version_{};
     int idx_ = -1;
     int saved_idx_ = -1;
     qint64 previous_position_{};
@@ -83,6 +94,12 @@ private:
     void play_next() noexcept;
     void play_prev() noexcept;
     void set_song(QString const& path) noexcept;
+    void show_song(QString const& path) noexcept;
+    void song_started(QString const& path) noexcept;
+    void preload_next() noexcept;
+    void prefetch() noexcept;
+    float gain(QString const& path, int idx) const noexcept;
+    void set_crossfade(qint64 ms) noexcept;
     void playback_changed() const noexcept;
     void showEvent(QShowEvent*) override;
     void customEvent(QEvent*) override;
@@ -0,0 +1,148 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "content_hash.h"
+#include <bit>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+    constexpr uint64_t PRIME1{0x9E37'79B1'85EB'CA87};
+    constexpr uint64_t PRIME2{0xC2B2'AE3D'27D4'EB4F};
+    constexpr uint64_t PRIME3{0x1656'67B1'9E37'79F9};
+    constexpr uint64_t PRIME4{0x85EB'CA77'C2B2'AE63};
+    constexpr uint64_t PRIME5{0x27D4'EB2F'1656'67C5};
+
+    uint64_t read64(uint8_t const* const p) noexcept {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    uint32_t read32(uint8_t const* const p) noexcept {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    uint64_t round(uint64_t acc, uint64_t const input) noexcept {
+        acc += input * PRIME2;
+        return std::rotl(acc, 31) * PRIME1;
+    }
+    uint64_t merge(uint64_t acc, uint64_t const value) noexcept {
+        acc ^= round(0, value);
+        return acc * PRIME1 + PRIME4;
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           x x h 6 4                              *
+ *                                                                  *
+ *******************************************************************/
+
+/// XXH64 as specified (little endian machines).
+uint64_t ContentHash::xxh64(span<uint8_t const> const data, uint64_t const seed) noexcept {
+    auto p = data.data();
+    auto const end = p + data.size();
+    uint64_t h{};
+
+    if (data.size() >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+        }
+        h = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        h = merge(h, v1);
+        h = merge(h, v2);
+        h = merge(h, v3);
+        h = merge(h, v4);
+    }
+    else
+        h = seed + PRIME5;
+    h += data.size();
+
+    for (; p + 8 <= end; p += 8)
+        h = std::rotl(h ^ round(0, read64(p)), 27) * PRIME1 + PRIME4;
+    if (p + 4 <= end) {
+        h = std::rotl(h ^ (uint64_t(read32(p)) * PRIME1), 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        h = std::rotl(h ^ (uint64_t(*p) * PRIME5), 11) * PRIME1;
+
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    return h ^ (h >> 32);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                             o f                                  *
+ *                                                                  *
+ *******************************************************************/
+
+/// Small files are hashed whole. The size goes at the end of the data,
+/// so files which differ only in length differ in the hash.
+auto ContentHash::of(string const& path, int64_t const size) noexcept
+-> optional<uint64_t> {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return {};
+
+    thread_local vector<uint8_t> data{};
+    data.clear();
+    auto const read_chunk = [fd] (int64_t const offset, int64_t const n) {
+        auto const first = data.size();
+        data.resize(first + size_t(n));
+        auto const got = ::pread(fd, data.data() + first, size_t(n), off_t(offset));
+        data.resize(first + size_t(std::max<ssize_t>(got, 0)));
+        return got == n;
+    };
+    auto const ok = (size <= 3 * CHUNK_SIZE)
+        ? read_chunk(0, size)
+        : read_chunk(0, CHUNK_SIZE)
+            && read_chunk((size - CHUNK_SIZE) / 2, CHUNK_SIZE)
+            && read_chunk(size - CHUNK_SIZE, CHUNK_SIZE);
+    ::close(fd);
+    if (!ok)
+        return {};
+
+    for (int i = 0; i < 8; ++i)
+        data.push_back(uint8_t(uint64_t(size) >> (8 * i)));
+    return xxh64(data);
+}
@@ -0,0 +1,48 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <string>
+#include <cstdint>
+#include <optional>
+
+/*------- ContentHash:
+-------------------------------------------------------------------*/
+/// Identity of the file's content which survives renames and moves.
+/// Only three chunks are read (from the head, the middle and the tail),
+/// they go with the file size through XXH64. For songs it is enough:
+/// two different files of the same size with the same 192 KiB in these
+/// places practically don't happen.
+class ContentHash {
+    static constexpr int64_t CHUNK_SIZE{64 * 1024};
+public:
+    /// Hash of the file (nothing if it can't be read). 'size' is the size from stat.
+    static std::optional<uint64_t> of(std::string const& path, int64_t size) noexcept;
+    /// XXH64 of the data.
+    static uint64_t xxh64(std::span<uint8_t const> data, uint64_t seed = 0) noexcept;
+};
@@ -0,0 +1,252 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dir_scanner.h"
+#include <chrono>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+using namespace std;
+using namespace std::chrono_literals;
+
+DirScanner::DirScanner(uint const workers) :
+    workers_count_{std::max(1u, workers)},
+    queues_(workers_count_)
+{}
+
+DirScanner::~DirScanner() {
+    cancel();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          s t a r t                               *
+ *                                                                  *
+ *******************************************************************/
+
+uint DirScanner::start(string const& root, BatchFn on_batch, FinishFn on_finish, FileFilter file_filter) {
+    cancel();
+
+    auto const generation = ++generation_;
+    on_batch_ = std::move(on_batch);
+    on_finish_ = std::move(on_finish);
+    file_filter_ = std::move(file_filter);
+
+    pending_ = 1;
+    queues_[0].dirs.emplace_back(root);
+    alive_ = workers_count_;
+    for (uint i = 0; i < workers_count_; ++i)
+        workers_.emplace_back([this, i, generation] (stop_token const& token) {
+            run(token, i, generation);
+        });
+    return generation;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          c a n c e l                             *
+ *                                                                  *
+ *******************************************************************/
+
+void DirScanner::cancel() noexcept {
+    for (auto& worker : workers_)
+        worker.request_stop();
+    cv_.notify_all();
+    // jthread joins in its destructor.
+    workers_.clear();
+
+    for (auto& queue : queues_)
+        queue.dirs.clear();
+    pending_ = 0;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            r u n                                 *
+ *                                                                  *
+ *******************************************************************/
+
+void DirScanner::run(stop_token const& token, uint const idx, uint const generation) {
+    Batch batch{};
+    batch.reserve(BATCH_SIZE);
+
+    auto flush = [&] {
+        if (!batch.empty() && !token.stop_requested()) {
+            on_batch_(generation, std::move(batch));
+            batch = {};
+            batch.reserve(BATCH_SIZE);
+        }
+    };
+
+    fs::path dir{};
+    while (!token.stop_requested()) {
+        if (take(idx, dir)) {
+            read_dir(token, idx, dir, batch);
+            if (batch.size() >= BATCH_SIZE)
+                flush();
+            // The last directory has been read, wake up the others so they can finish.
+            if (pending_.fetch_sub(1) == 1)
+                cv_.notify_all();
+            continue;
+        }
+        // Nothing to do (and nothing to steal). Before we go to sleep
+        // we give away what we have found so far.
+        flush();
+        if (pending_.load() == 0)
+            break;
+        unique_lock<mutex> lock{mutex_};
+        cv_.wait_for(lock, token, 2ms, [this] { return pending_.load() == 0; });
+    }
+
+    // The finish is reported by the last worker, after every batch was sent.
+    if (alive_.fetch_sub(1) == 1 && !token.stop_requested() && on_finish_)
+        on_finish_(generation);
+}
+
+/********************************************************************
+ *                                                                  *
+ *                   t a k e   &   p u s h                          *
+ *                                                                  *
+ *******************************************************************/
+
+/// Take a directory from own queue (LIFO), if it is empty steal from others (FIFO).
+bool DirScanner::take(uint const idx, fs::path& dir) {
+    {
+        auto& own = queues_[idx];
+        lock_guard<mutex> lg{own.mutex};
+        if (!own.dirs.empty()) {
+            dir = std::move(own.dirs.back());
+            own.dirs.pop_back();
+            return true;
+        }
+    }
+    for (uint i = 1; i < workers_count_; ++i) {
+        auto& victim = queues_[(idx + i) % workers_count_];
+        lock_guard<mutex> lg{victim.mutex};
+        if (!victim.dirs.empty()) {
+            dir = std::move(victim.dirs.front());
+            victim.dirs.pop_front();
+            return true;
+        }
+    }
+    return {};
+}
+
+void DirScanner::push(uint const idx, fs::path dir) {
+    ++pending_;
+    {
+        auto& own = queues_[idx];
+        lock_guard<mutex> lg{own.mutex};
+        own.dirs.push_back(std::move(dir));
+    }
+    cv_.notify_one();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                       r e a d _ d i r                            *
+ *                                                                  *
+ *******************************************************************/
+
+/// Read one directory (one getdents64 stream). The type of entry is taken
+/// from the directory entry itself (d_type), so we don't call stat for
+/// regular entries. Hidden directories are skipped. Symbolic links to
+/// directories are reported, but we don't go inside (protection against cycles).
+/// Files are collected only when the scan has a file filter.
+void DirScanner::read_dir(stop_token const& token, uint const idx, fs::path const& dir, Batch& batch) {
+    error_code ec{};
+    fs::directory_iterator it{dir, fs::directory_options::skip_permission_denied, ec};
+    if (ec) return;
+
+    Listing listing{dir.native()};
+    for (fs::directory_iterator const end{}; it != end; it.increment(ec)) {
+        if (ec || token.stop_requested())
+            return;
+        auto const& entry = *it;
+        if (is_hidden(entry.path()))
+            continue;
+        if (!entry.is_directory(ec)) {
+            if (file_filter_ && entry.is_regular_file(ec) && file_filter_(entry.path().filename().native()))
+                listing.files.push_back(entry.path().filename().native());
+            continue;
+        }
+        listing.subdirs.push_back(entry.path().filename().native());
+        if (!entry.is_symlink(ec))
+            push(idx, entry.path());
+    }
+    batch.push_back(std::move(listing));
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            l i s t                               *
+ *                                                                  *
+ *******************************************************************/
+
+auto DirScanner::list(string const& dir)
+-> Listing {
+    Listing listing{dir};
+    error_code ec{};
+    fs::directory_iterator it{dir, fs::directory_options::skip_permission_denied, ec};
+    if (ec) return listing;
+
+    for (fs::directory_iterator const end{}; it != end; it.increment(ec)) {
+        if (ec) break;
+        auto const& entry = *it;
+        if (!is_hidden(entry.path()) && entry.is_directory(ec))
+            listing.subdirs.push_back(entry.path().filename().native());
+    }
+    return listing;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                     h a s _ s u b d i r s                        *
+ *                                                                  *
+ *******************************************************************/
+
+/// On most local file systems the number of links of the directory is
+/// 2 + number of its subdirectories ('.' and '..' of every child), so one
+/// stat tells there are none. Otherwise (some subdirectories, which may all
+/// be hidden, or a file system which doesn't count links this way: btrfs,
+/// some network mounts report 1) we read entries until the first visible directory.
+bool DirScanner::has_subdirs(string const& dir) {
+    struct stat st{};
+    if (::stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+        return {};
+    if (st.st_nlink == 2)
+        return {};
+
+    error_code ec{};
+    fs::directory_iterator it{dir, fs::directory_options::skip_permission_denied, ec};
+    if (ec) return {};
+    for (fs::directory_iterator const end{}; it != end; it.increment(ec)) {
+        if (ec) break;
+        if (!is_hidden(it->path()) && it->is_directory(ec))
+            return true;
+    }
+    return {};
+}
@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <filesystem>
+#include <string_view>
+#include <condition_variable>
+
+/*------- DirScanner:
+-------------------------------------------------------------------*/
+/// Multi-threaded, work-stealing directory walker.
+/// Every worker owns a queue of directories still to read. A worker takes
+/// work from the back of its own queue and, when it runs dry, steals from
+/// the front of the others. Listings of read directories are handed out in batches
+/// (on the worker threads!) through the 'on_batch' callback.
+/// Starting a new scan cancels the previous one.
+class DirScanner {
+public:
+    /// Read directory with names of its (not hidden) subdirectories
+    /// and of the files accepted by the file filter (if one was given).
+    struct Listing {
+        std::string path{};
+        std::vector<std::string> subdirs{};
+        std::vector<std::string> files{};
+    };
+    using Batch = std::vector<Listing>;
+    using BatchFn = std::function<void(uint generation, Batch&&)>;
+    using FinishFn = std::function<void(uint generation)>;
+    using FileFilter = std::function<bool(std::string_view name)>;
+    static constexpr size_t BATCH_SIZE{256};
+
+private:
+    struct WorkQueue {
+        std::mutex mutex{};
+        std::deque<std::filesystem::path> dirs{};
+    };
+
+    uint const workers_count_;
+    std::vector<WorkQueue> queues_;
+    std::vector<std::jthread> workers_{};
+    std::mutex mutex_{};
+    std::condition_variable_any cv_{};
+    std::atomic<size_t> pending_{};
+    std::atomic<uint> generation_{};
+    std::atomic<uint> alive_{};
+    BatchFn on_batch_{};
+    FinishFn on_finish_{};
+    FileFilter file_filter_{};
+
+public:
+    explicit DirScanner(uint workers = std::thread::hardware_concurrency());
+    ~DirScanner();
+    DirScanner(DirScanner const&) = delete;
+    DirScanner& operator=(DirScanner const&) = delete;
+    DirScanner(DirScanner&&) = delete;
+    DirScanner& operator=(DirScanner&&) = delete;
+
+    /// Start (in background) scanning of directories under the passed root.
+    /// The scan that is currently running is cancelled first.
+    /// \param root - directory from which we start,
+    /// \param on_batch - receiver of found directories (called from worker threads),
+    /// \param on_finish - called once, when the whole tree was scanned (not called if cancelled),
+    /// \param file_filter - if given, names of regular files it accepts are reported too.
+    /// \return generation of the started scan (it is passed to callbacks).
+    uint start(std::string const& root, BatchFn on_batch, FinishFn on_finish, FileFilter file_filter = {});
+
+    /// Stop the currently running scan and wait for the workers.
+    void cancel() noexcept;
+
+    uint generation() const noexcept {
+        return generation_.load();
+    }
+
+    /// Synchronous listing of one directory (without going deeper).
+    static Listing list(std::string const& dir);
+    /// Cheap check if the directory has any subdirectory.
+    static bool has_subdirs(std::string const& dir);
+
+private:
+    void run(std::stop_token const& token, uint idx, uint generation);
+    bool take(uint idx, std::filesystem::path& dir);
+    void push(uint idx, std::filesystem::path dir);
+    void read_dir(std::stop_token const& token, uint idx, std::filesystem::path const& dir, Batch& batch);
+    static bool is_hidden(std::filesystem::path const& path) noexcept {
+        auto const name = path.filename();
+        return name.empty() || name.native()[0] == '.';
+    }
+};
@@ -0,0 +1,366 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dir_watcher.h"
+#include <filesystem>
+#include <iostream>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+namespace fs = std::filesystem;
+using namespace std;
+using namespace std::chrono_literals;
+
+/*------- local constants:
+-------------------------------------------------------------------*/
+namespace {
+    constexpr uint32_t MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONT_FOLLOW;
+    constexpr int WAIT_MS = 100;
+
+    bool is_hidden(string_view const name) noexcept {
+        return name.empty() || name[0] == '.';
+    }
+    bool is_inside(string const& path, string const& dir) noexcept {
+        return path.size() > dir.size() && path.starts_with(dir) && path[dir.size()] == '/';
+    }
+}
+
+DirWatcher::DirWatcher(ChangesFn on_changes) :
+    on_changes_{std::move(on_changes)},
+    fd_{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)},
+    thread_{[this] (stop_token const& token) { run(token); }}
+{
+    if (fd_ < 0)
+        cerr << "inotify is not available, library directories will be polled\n";
+}
+
+DirWatcher::~DirWatcher() {
+    thread_.request_stop();
+    if (thread_.joinable())
+        thread_.join();
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+void DirWatcher::watch(DirScanner::Listing const& listing) noexcept {
+    lock_guard<mutex> lg{mutex_};
+    auto const& dir = listing.path;
+    add(dir);
+
+    // What changed between the scanner's read and the watch is never reported
+    // by inotify, so the directory is read again. The count of its links
+    // (2 + subdirectories) tells cheaply that it wasn't needed.
+    if (struct stat st{}; ::stat(dir.c_str(), &st) == 0 && st.st_nlink == 2 + listing.subdirs.size())
+        return;
+    auto const current = DirScanner::list(dir).subdirs;
+    unordered_set<string> const known(listing.subdirs.begin(), listing.subdirs.end());
+    unordered_set<string> const now(current.begin(), current.end());
+    for (auto const& name : current)
+        if (!known.contains(name)) {
+            watch_tree(dir + '/' + name);
+            note(dir + '/' + name, true, true);
+        }
+    for (auto const& name : listing.subdirs)
+        if (!now.contains(name)) {
+            unwatch_tree(dir + '/' + name);
+            note(dir + '/' + name, false, true);
+        }
+}
+
+void DirWatcher::clear() noexcept {
+    lock_guard<mutex> lg{mutex_};
+    for (auto const& [wd, _] : paths_)
+        inotify_rm_watch(fd_, wd);
+    paths_.clear();
+    wds_.clear();
+    polled_.clear();
+    pending_.clear();
+    writing_.clear();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                             r u n                                *
+ *                                                                  *
+ *******************************************************************/
+
+void DirWatcher::run(stop_token const& token) {
+    while (!token.stop_requested()) {
+        if (fd_ >= 0) {
+            pollfd pfd{fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, WAIT_MS) > 0 && (pfd.revents & POLLIN)) {
+                lock_guard<mutex> lg{mutex_};
+                read_events();
+            }
+        }
+        else
+            this_thread::sleep_for(chrono::milliseconds(WAIT_MS));
+
+        Changes changes{};
+        {
+            lock_guard<mutex> lg{mutex_};
+            auto const now = Clock::now();
+            if (now - last_poll_ >= POLL_INTERVAL) {
+                poll();
+                last_poll_ = now;
+            }
+            if (!pending_.empty() && (now - last_change_ >= DEBOUNCE || now - first_change_ >= MAX_DELAY))
+                changes = take_changes();
+        }
+        // Receiver is called without the lock (it may want to watch something).
+        if (!changes.empty() && on_changes_)
+            on_changes_(std::move(changes));
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                     r e a d _ e v e n t s                        *
+ *                                                                  *
+ *******************************************************************/
+
+void DirWatcher::read_events() {
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    for (;;) {
+        auto const n = ::read(fd_, buffer, sizeof(buffer));
+        if (n <= 0)
+            return;
+
+        for (auto ptr = buffer; ptr < buffer + n; ) {
+            auto const ev = reinterpret_cast<inotify_event const*>(ptr);
+            ptr += sizeof(inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                cerr << "inotify queue overflow, some library changes were lost\n";
+                continue;
+            }
+            auto const it = paths_.find(ev->wd);
+            if (it == paths_.end())
+                continue;
+            // The directory was removed (or unwatched), the kernel dropped the watch.
+            if (ev->mask & IN_IGNORED) {
+                wds_.erase(it->second);
+                paths_.erase(it);
+                continue;
+            }
+            if (ev->len == 0 || is_hidden(ev->name))
+                continue;
+
+            auto const path = it->second + '/' + ev->name;
+            bool const is_dir = ev->mask & IN_ISDIR;
+            // A created file comes when it is closed, the one never closed isn't reported at all.
+            if (!is_dir && (ev->mask & IN_CREATE)) {
+                writing_.insert(path);
+                continue;
+            }
+            if (ev->mask & IN_CLOSE_WRITE) {
+                if (writing_.erase(path))
+                    note(path, true, false);
+                continue;
+            }
+            if (!is_dir && (ev->mask & (IN_DELETE | IN_MOVED_FROM)) && writing_.erase(path))
+                continue;
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                if (is_dir) watch_tree(path);
+                note(path, true, is_dir);
+            }
+            else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                if (is_dir) unwatch_tree(path);
+                note(path, false, is_dir);
+            }
+            // Both halves of a rename carry the same cookie.
+            if (!is_dir && (ev->mask & IN_MOVED_FROM))
+                moved_from_[ev->cookie] = path;
+            else if (!is_dir && (ev->mask & IN_MOVED_TO))
+                if (auto const from = moved_from_.find(ev->cookie); from != moved_from_.end()) {
+                    moves_.emplace_back(std::move(from->second), path);
+                    moved_from_.erase(from);
+                }
+        }
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            p o l l                               *
+ *                                                                  *
+ *******************************************************************/
+
+/// Fallback for directories which are not watched by inotify.
+/// We compare the current content of the directory with the previous
+/// one, but only if the mtime of the directory has changed.
+void DirWatcher::poll() {
+    vector<string> changed{};
+    for (auto const& [dir, snapshot] : polled_) {
+        struct stat st{};
+        if (::stat(dir.c_str(), &st) != 0
+            || st.st_mtim.tv_sec != snapshot.mtime.tv_sec
+            || st.st_mtim.tv_nsec != snapshot.mtime.tv_nsec)
+            changed.push_back(dir);
+    }
+
+    for (auto const& dir : changed) {
+        auto const it = polled_.find(dir);
+        if (it == polled_.end())
+            continue;   // removed with its parent in the meantime
+        auto current = snapshot_for(dir);
+        auto const previous = std::move(it->second.entries);
+        it->second = current;
+
+        for (auto const& [name, is_dir] : previous)
+            if (!current.entries.contains(name)) {
+                if (is_dir) unwatch_tree(dir + '/' + name);
+                note(dir + '/' + name, false, is_dir);
+            }
+        for (auto const& [name, is_dir] : current.entries)
+            if (!previous.contains(name)) {
+                if (is_dir) watch_tree(dir + '/' + name);
+                note(dir + '/' + name, true, is_dir);
+            }
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                   w a t c h  /  u n w a t c h                    *
+ *                                                                  *
+ *******************************************************************/
+
+void DirWatcher::add(string const& dir) {
+    if (wds_.contains(dir) || polled_.contains(dir))
+        return;
+    if (fd_ >= 0)
+        if (auto const wd = inotify_add_watch(fd_, dir.c_str(), MASK); wd >= 0) {
+            paths_[wd] = dir;
+            wds_[dir] = wd;
+            return;
+        }
+    // No inotify or the limit of watches is reached (ENOSPC).
+    polled_.emplace(dir, snapshot_for(dir));
+}
+
+/// The directory (maybe with a content) appeared.
+void DirWatcher::watch_tree(string const& dir) {
+    vector<string> stack{dir};
+    while (!stack.empty()) {
+        auto const current = std::move(stack.back());
+        stack.pop_back();
+        add(current);
+        for (auto const& name : DirScanner::list(current).subdirs)
+            stack.push_back(current + '/' + name);
+    }
+}
+
+/// The directory disappeared (removed or moved somewhere).
+void DirWatcher::unwatch_tree(string const& dir) {
+    erase_if(writing_, [&dir] (auto const& path) {
+        return is_inside(path, dir);
+    });
+    for (auto it = wds_.begin(); it != wds_.end(); ) {
+        if (it->first == dir || is_inside(it->first, dir)) {
+            inotify_rm_watch(fd_, it->second);
+            paths_.erase(it->second);
+            it = wds_.erase(it);
+        }
+        else
+            ++it;
+    }
+    erase_if(polled_, [&dir] (auto const& item) {
+        return item.first == dir || is_inside(item.first, dir);
+    });
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            n o t e                               *
+ *                                                                  *
+ *******************************************************************/
+
+/// Remember the change. Changes of the same path are merged,
+/// e.g. a file created and removed before the flush is forgotten.
+void DirWatcher::note(string const& path, bool const created, bool const is_dir) {
+    auto const now = Clock::now();
+    if (pending_.empty())
+        first_change_ = now;
+    last_change_ = now;
+
+    auto& pending = pending_[path];
+    pending.is_dir = is_dir;
+    if (created)
+        pending.created = true;
+    else if (pending.created && !pending.removed)
+        pending_.erase(path);
+    else {
+        pending.created = false;
+        pending.removed = true;
+    }
+}
+
+auto DirWatcher::take_changes()
+-> Changes {
+    Changes changes{};
+    // Only moves which still hold (the file wasn't moved back or removed).
+    for (auto& [from, to] : moves_) {
+        auto const removed = pending_.find(from);
+        auto const created = pending_.find(to);
+        if (removed != pending_.end() && removed->second.removed && !removed->second.created
+            && created != pending_.end() && created->second.created)
+            changes.moved_files.emplace_back(std::move(from), std::move(to));
+    }
+    moves_.clear();
+    moved_from_.clear();
+    for (auto& [path, pending] : pending_) {
+        if (pending.removed)
+            (pending.is_dir ? changes.removed_dirs : changes.removed_files).push_back(path);
+        if (pending.created)
+            (pending.is_dir ? changes.created_dirs : changes.created_files).push_back(path);
+    }
+    pending_.clear();
+    return changes;
+}
+
+auto DirWatcher::snapshot_for(string const& dir)
+-> Snapshot {
+    Snapshot snapshot{};
+    struct stat st{};
+    if (::stat(dir.c_str(), &st) != 0)
+        return snapshot;
+    snapshot.mtime = st.st_mtim;
+
+    error_code ec{};
+    fs::directory_iterator it{dir, fs::directory_options::skip_permission_denied, ec};
+    if (ec) return snapshot;
+    for (fs::directory_iterator const end{}; it != end; it.increment(ec)) {
+        if (ec) break;
+        auto const name = it->path().filename().string();
+        if (!is_hidden(name))
+            snapshot.entries.emplace(name, it->is_directory(ec));
+    }
+    return snapshot;
+}
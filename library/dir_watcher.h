@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dir_scanner.h"
+#include <map>
+#include <mutex>
+#include <ctime>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+/*------- DirWatcher:
+-------------------------------------------------------------------*/
+/// Watching of the music library for changes (inotify).
+/// Directories to watch are added one by one (inotify is not recursive),
+/// directories created later are added automatically.
+/// A new file is reported when it is written and closed (a song still
+/// being copied to the library isn't taken), or when it is moved in.
+/// If inotify can't be used (not available, limit of watches reached)
+/// the directory is checked periodically (its mtime) and its content
+/// is compared with the previous one.
+/// Changes are collected and handed out together (on the watcher thread!),
+/// when nothing happened for DEBOUNCE time (but not later than MAX_DELAY).
+class DirWatcher {
+public:
+    struct Changes {
+        std::vector<std::string> created_dirs{};
+        std::vector<std::string> removed_dirs{};
+        std::vector<std::string> created_files{};
+        std::vector<std::string> removed_files{};
+        // Renamed/moved within the library (from, to), also in removed and created.
+        std::vector<std::pair<std::string, std::string>> moved_files{};
+
+        bool empty() const noexcept {
+            return created_dirs.empty() && removed_dirs.empty()
+                && created_files.empty() && removed_files.empty();
+        }
+    };
+    using ChangesFn = std::function<void(Changes&&)>;
+    static constexpr std::chrono::milliseconds DEBOUNCE{300};
+    static constexpr std::chrono::milliseconds MAX_DELAY{2000};
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{5000};
+
+private:
+    // What happened to the path since the last flush.
+    struct Pending {
+        bool removed{};
+        bool created{};
+        bool is_dir{};
+    };
+    // Content of the polled directory (name -> is directory).
+    struct Snapshot {
+        std::timespec mtime{};
+        std::map<std::string, bool> entries{};
+    };
+    using Clock = std::chrono::steady_clock;
+
+    ChangesFn const on_changes_;
+    int fd_{-1};
+    std::mutex mutex_{};
+    std::unordered_map<int, std::string> paths_{};     // watch descriptor -> directory
+    std::unordered_map<std::string, int> wds_{};       // directory -> watch descriptor
+    std::unordered_map<std::string, Snapshot> polled_{};
+    std::map<std::string, Pending> pending_{};         // ordered: parents before children
+    std::unordered_map<uint32_t, std::string> moved_from_{};   // inotify cookie -> file
+    std::vector<std::pair<std::string, std::string>> moves_{};
+    std::unordered_set<std::string> writing_{};        // created files, not closed yet
+    Clock::time_point first_change_{};
+    Clock::time_point last_change_{};
+    Clock::time_point last_poll_{};
+    std::jthread thread_;
+
+public:
+    explicit DirWatcher(ChangesFn on_changes);
+    ~DirWatcher();
+    DirWatcher(DirWatcher const&) = delete;
+    DirWatcher& operator=(DirWatcher const&) = delete;
+    DirWatcher(DirWatcher&&) = delete;
+    DirWatcher& operator=(DirWatcher&&) = delete;
+
+    /// Start watching the directory read by the scanner (thread safe, no recursion).
+    /// Subdirectories which came or went since the scanner read it are reported.
+    void watch(DirScanner::Listing const& listing) noexcept;
+    /// Stop watching everything.
+    void clear() noexcept;
+
+private:
+    void run(std::stop_token const& token);
+    // Functions below expect that the mutex_ is locked.
+    void read_events();
+    void poll();
+    void add(std::string const& dir);
+    void watch_tree(std::string const& dir);
+    void unwatch_tree(std::string const& dir);
+    void note(std::string const& path, bool created, bool is_dir);
+    Changes take_changes();
+    static Snapshot snapshot_for(std::string const& dir);
+};
@@ -0,0 +1,126 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "prefetcher.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+using namespace std;
+
+Prefetcher::Prefetcher() :
+    buffer_(CHUNK_SIZE),
+    worker_{[this] (stop_token const& token) { run(token); }}
+{}
+
+Prefetcher::~Prefetcher() {
+    worker_.request_stop();
+    cv_.notify_all();
+    // jthread joins in its destructor.
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        p r e f e t c h                           *
+ *                                                                  *
+ *******************************************************************/
+
+void Prefetcher::prefetch(vector<string> paths) noexcept {
+    {
+        lock_guard<mutex> lg{mutex_};
+        paths_ = std::move(paths);
+        pending_ = true;
+        // The worker checks it between chunks, so it drops the old list quickly.
+        ++generation_;
+    }
+    cv_.notify_one();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            r u n                                 *
+ *                                                                  *
+ *******************************************************************/
+
+void Prefetcher::run(stop_token const& token) {
+    while (!token.stop_requested()) {
+        vector<string> paths{};
+        uint generation{};
+        {
+            unique_lock<mutex> lock{mutex_};
+            if (!cv_.wait(lock, token, [this] { return pending_; }))
+                return;
+            paths = std::move(paths_);
+            pending_ = false;
+            generation = generation_;
+        }
+
+        // Songs that fell out of the look-ahead don't count anymore.
+        erase_if(warm_, [&paths] (auto const& item) {
+            return std::ranges::find(paths, item.first) == paths.end();
+        });
+
+        auto budget = BUDGET;
+        for (auto const& path : paths) {
+            if (!budget || generation != generation_ || token.stop_requested())
+                break;
+            budget -= warm(token, generation, path, budget);
+        }
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                           w a r m                                *
+ *                                                                  *
+ *******************************************************************/
+
+size_t Prefetcher::warm(stop_token const& token, uint const generation, string const& path, size_t const budget) noexcept {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return {};
+
+    struct stat st{};
+    auto const size = (::fstat(fd, &st) == 0) ? std::min(size_t(st.st_size), budget) : 0;
+    auto& done = warm_[path];
+
+    // A hint is enough for a local disk, but on NFS/SMB only reading
+    // really brings the data over, so we read it (and forget it).
+    if (done < size)
+        ::posix_fadvise(fd, off_t(done), off_t(size - done), POSIX_FADV_WILLNEED);
+    while (done < size) {
+        if (generation != generation_ || token.stop_requested())
+            break;
+        auto const n = ::pread(fd, buffer_.data(), std::min(CHUNK_SIZE, size - done), off_t(done));
+        if (n <= 0)
+            break;
+        done += size_t(n);
+    }
+
+    ::close(fd);
+    return std::min(done, size);
+}
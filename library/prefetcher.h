@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <condition_variable>
+
+/*------- Prefetcher:
+-------------------------------------------------------------------*/
+/// Warms the page cache with the songs that will be played next,
+/// so a song from a slow (network) disk starts without a stall.
+/// Files are read in the background, in the order given, until
+/// BUDGET bytes of the whole look-ahead are in memory.
+/// A new list cancels the work on the previous one.
+class Prefetcher {
+public:
+    static constexpr size_t LOOKAHEAD{3};
+    static constexpr size_t BUDGET{96 * 1024 * 1024};
+    static constexpr size_t CHUNK_SIZE{1024 * 1024};
+private:
+    std::mutex mutex_{};
+    std::condition_variable_any cv_{};
+    std::vector<std::string> paths_{};
+    bool pending_{};
+    std::atomic<uint> generation_{};
+    // Only for the worker: how many bytes of a file are already warm.
+    std::unordered_map<std::string, size_t> warm_{};
+    std::vector<char> buffer_;
+    std::jthread worker_;
+public:
+    Prefetcher();
+    ~Prefetcher();
+    Prefetcher(Prefetcher const&) = delete;
+    Prefetcher& operator=(Prefetcher const&) = delete;
+    Prefetcher(Prefetcher&&) = delete;
+    Prefetcher& operator=(Prefetcher&&) = delete;
+
+    /// Songs to warm (most urgent first), replaces the previous list.
+    void prefetch(std::vector<std::string> paths) noexcept;
+
+private:
+    void run(std::stop_token const& token);
+    size_t warm(std::stop_token const& token, uint generation, std::string const& path, size_t budget) noexcept;
+};
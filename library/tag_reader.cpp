@@ -0,0 +1,434 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "tag_reader.h"
+#include "../audio/seek_index.h"
+#include <array>
+#include <string_view>
+#include <algorithm>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+namespace {
+    uint32_t be32(uint8_t const* const p) noexcept {
+        return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+    }
+    uint32_t be24(uint8_t const* const p) noexcept {
+        return uint32_t(p[0]) << 16 | uint32_t(p[1]) << 8 | p[2];
+    }
+    uint32_t syncsafe(uint8_t const* const p) noexcept {
+        return uint32_t(p[0] & 0x7F) << 21 | uint32_t(p[1] & 0x7F) << 14 | uint32_t(p[2] & 0x7F) << 7 | (p[3] & 0x7F);
+    }
+    uint64_t be64(uint8_t const* const p) noexcept {
+        return uint64_t(be32(p)) << 32 | be32(p + 4);
+    }
+
+    void append_utf8(string& out, uint32_t const cp) {
+        if (cp < 0x80)
+            out += char(cp);
+        else if (cp < 0x800) {
+            out += char(0xC0 | cp >> 6);
+            out += char(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            out += char(0xE0 | cp >> 12);
+            out += char(0x80 | (cp >> 6 & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+        else {
+            out += char(0xF0 | cp >> 18);
+            out += char(0x80 | (cp >> 12 & 0x3F));
+            out += char(0x80 | (cp >> 6 & 0x3F));
+            out += char(0x80 | (cp & 0x3F));
+        }
+    }
+
+    string latin1_to_utf8(uint8_t const* p, uint8_t const* const end) {
+        string out{};
+        for (; p < end && *p; ++p)
+            append_utf8(out, *p);
+        return out;
+    }
+
+    string utf16_to_utf8(uint8_t const* p, uint8_t const* const end, bool big_endian) {
+        if (end - p >= 2) {
+            if (p[0] == 0xFF && p[1] == 0xFE) { big_endian = false; p += 2; }
+            else if (p[0] == 0xFE && p[1] == 0xFF) { big_endian = true; p += 2; }
+        }
+        auto const unit = [big_endian] (uint8_t const* const q) -> uint32_t {
+            return big_endian ? (q[0] << 8 | q[1]) : (q[1] << 8 | q[0]);
+        };
+        string out{};
+        while (end - p >= 2) {
+            auto cp = unit(p);
+            p += 2;
+            if (!cp)
+                break;
+            if (cp >= 0xD800 && cp < 0xDC00 && end - p >= 2) {
+                auto const low = unit(p);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    p += 2;
+                }
+            }
+            append_utf8(out, cp);
+        }
+        return out;
+    }
+
+    string trimmed(string text) {
+        auto const last = text.find_last_not_of(" \t\r\n");
+        text.erase(last == string::npos ? 0 : last + 1);
+        auto const first = text.find_first_not_of(" \t\r\n");
+        text.erase(0, first == string::npos ? text.size() : first);
+        return text;
+    }
+
+    /// Leading number of the text ("3/12" -> 3, "2004-05-01" -> 2004).
+    int leading_number(string_view const text) noexcept {
+        int value{};
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+    /// Removes the ID3 unsynchronisation (0xFF 0x00 -> 0xFF).
+    void resync(vector<uint8_t>& data) noexcept {
+        auto out = data.begin();
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            *out++ = *it;
+            if (*it == 0xFF && it + 1 != data.end() && *(it + 1) == 0x00)
+                ++it;
+        }
+        data.erase(out, data.end());
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            r e a d                               *
+ *                                                                  *
+ *******************************************************************/
+
+auto TagReader::read(string const& path) noexcept
+-> optional<Tags> {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return {};
+
+    Tags tags{};
+    auto found = false;
+    if (path.ends_with(".m4a") || path.ends_with(".M4A"))
+        found = read_mp4(fd, tags);
+    else {
+        found = read_id3v2(fd, tags);
+        if (!tags.complete())
+            found |= read_id3v1(fd, tags);
+    }
+    ::close(fd);
+    if (auto const index = SeekIndex::read(path)) {
+        tags.duration_ms = index->duration_ms();
+        found = true;
+    }
+
+    if (!found)
+        return {};
+    tags.title = trimmed(std::move(tags.title));
+    tags.artist = trimmed(std::move(tags.artist));
+    tags.album = trimmed(std::move(tags.album));
+    return tags;
+}
+
+auto TagReader::read_at(int const fd, int64_t const offset, size_t const size) noexcept
+-> Bytes {
+    Bytes data(size);
+    auto const n = ::pread(fd, data.data(), size, off_t(offset));
+    data.resize(n > 0 ? size_t(n) : 0);
+    return data;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        r e a d _ i d 3 v 2                       *
+ *                                                                  *
+ *******************************************************************/
+
+bool TagReader::read_id3v2(int const fd, Tags& tags) noexcept {
+    auto const header = read_at(fd, 0, 10);
+    if (header.size() < 10 || header[0] != 'I' || header[1] != 'D' || header[2] != '3')
+        return {};
+    auto const version = header[3];
+    if (version < 2 || version > 4)
+        return {};
+    auto const flags = header[5];
+    int64_t const end = 10 + syncsafe(&header[6]);
+
+    // The whole tag unsynchronised (before v2.4): the positions of frames
+    // are known only after resync, so we have to read everything
+    // (up to MAX_UNSYNC_SIZE: text frames come first, pictures after them).
+    Bytes tag{};
+    auto const in_memory = version < 4 && (flags & 0x80);
+    if (in_memory) {
+        tag = read_at(fd, 10, size_t(std::min<int64_t>(end - 10, MAX_UNSYNC_SIZE)));
+        resync(tag);
+    }
+    auto const fetch = [&] (int64_t const offset, size_t const size) -> Bytes {
+        if (!in_memory)
+            return read_at(fd, offset, size);
+        auto const first = size_t(std::min<int64_t>(offset - 10, int64_t(tag.size())));
+        auto const last = std::min(first + size, tag.size());
+        return {tag.begin() + first, tag.begin() + last};
+    };
+
+    int64_t pos = 10;
+    if (flags & 0x40) {
+        // Extended header.
+        auto const ext = fetch(pos, 4);
+        if (ext.size() < 4)
+            return {};
+        pos += (version == 4) ? syncsafe(ext.data()) : 4 + be32(ext.data());
+    }
+
+    auto const header_size = (version == 2) ? 6 : 10;
+    auto found = false;
+    while (pos + header_size <= end) {
+        auto const fh = fetch(pos, size_t(header_size));
+        if (fh.size() < size_t(header_size) || fh[0] == 0)
+            break;      // padding
+
+        string_view const id{reinterpret_cast<char const*>(fh.data()), size_t(version == 2 ? 3 : 4)};
+        uint32_t size{};
+        uint8_t format{};
+        if (version == 2)
+            size = be24(&fh[3]);
+        else {
+            size = (version == 4) ? syncsafe(&fh[4]) : be32(&fh[4]);
+            format = fh[9];
+        }
+        auto const body_at = pos + header_size;
+        pos = body_at + size;
+        if (pos > end)
+            break;
+
+        // Only text frames, and not compressed/encrypted ones.
+        if (id[0] != 'T' || size == 0 || size > MAX_TEXT_SIZE)
+            continue;
+        auto const packed = (version == 3) ? (format & 0xC0) : (version == 4) ? (format & 0x0C) : 0;
+        if (packed)
+            continue;
+
+        auto body = fetch(body_at, size);
+        if (version == 4) {
+            if (format & 0x01)     // data length indicator
+                body.erase(body.begin(), body.begin() + std::min<size_t>(4, body.size()));
+            if ((format & 0x02) || (flags & 0x80))
+                resync(body);
+        }
+        id3_frame(id, body, tags);
+        found = true;
+    }
+    return found;
+}
+
+void TagReader::id3_frame(string_view const id, Bytes const& body, Tags& tags) noexcept {
+    if (id == "TIT2" || id == "TT2")
+        tags.title = id3_text(body);
+    else if (id == "TPE1" || id == "TP1")
+        tags.artist = id3_text(body);
+    else if ((id == "TPE2" || id == "TP2") && tags.artist.empty())
+        tags.artist = id3_text(body);     // album artist, if there is no artist
+    else if (id == "TALB" || id == "TAL")
+        tags.album = id3_text(body);
+    else if (id == "TRCK" || id == "TRK")
+        tags.track = leading_number(id3_text(body));
+    else if (id == "TYER" || id == "TYE" || id == "TDRC")
+        tags.year = leading_number(id3_text(body));
+}
+
+/// Text of the frame (the first one, if there are more of them).
+string TagReader::id3_text(Bytes const& body) noexcept {
+    if (body.empty())
+        return {};
+    auto const begin = body.data() + 1;
+    auto const end = body.data() + body.size();
+    switch (body[0]) {
+    case 0: return latin1_to_utf8(begin, end);
+    case 1: return utf16_to_utf8(begin, end, false);
+    case 2: return utf16_to_utf8(begin, end, true);
+    case 3: return string(begin, std::find(begin, end, 0));
+    }
+    return {};
+}
+
+/********************************************************************
+ *                                                                  *
+ *                        r e a d _ i d 3 v 1                       *
+ *                                                                  *
+ *******************************************************************/
+
+/// Only fills what ID3v2 didn't give.
+bool TagReader::read_id3v1(int const fd, Tags& tags) noexcept {
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < 128)
+        return {};
+    auto const tag = read_at(fd, st.st_size - 128, 128);
+    if (tag.size() < 128 || tag[0] != 'T' || tag[1] != 'A' || tag[2] != 'G')
+        return {};
+
+    auto const field = [&tag] (size_t const offset, size_t const size) {
+        return latin1_to_utf8(&tag[offset], &tag[offset + size]);
+    };
+    if (tags.title.empty())
+        tags.title = field(3, 30);
+    if (tags.artist.empty())
+        tags.artist = field(33, 30);
+    if (tags.album.empty())
+        tags.album = field(63, 30);
+    if (!tags.year)
+        tags.year = leading_number(field(93, 4));
+    // ID3v1.1: the track is in the last byte of the comment.
+    if (!tags.track && tag[125] == 0 && tag[126] != 0)
+        tags.track = tag[126];
+    return true;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          r e a d _ m p 4                         *
+ *                                                                  *
+ *******************************************************************/
+
+bool TagReader::read_mp4(int const fd, Tags& tags) noexcept {
+    struct stat st{};
+    if (::fstat(fd, &st) != 0)
+        return {};
+
+    struct Atom {
+        int64_t body{};
+        int64_t end{};
+    };
+    // Child atom of the given type within [begin, end); only headers are read.
+    auto const find = [fd] (int64_t pos, int64_t const end, string_view const type) -> optional<Atom> {
+        while (pos + 8 <= end) {
+            auto const header = read_at(fd, pos, 16);
+            if (header.size() < 8)
+                return {};
+            int64_t size = be32(header.data());
+            auto header_size = 8;
+            if (size == 1 && header.size() == 16) {
+                size = int64_t(be64(&header[8]));
+                header_size = 16;
+            }
+            else if (size == 0)
+                size = end - pos;
+            // Sizes come from the file: compared without adding (no overflow).
+            if (size < header_size || size > end - pos)
+                return {};
+            if (string_view{reinterpret_cast<char const*>(&header[4]), 4} == type)
+                return Atom{pos + header_size, pos + size};
+            pos += size;
+        }
+        return {};
+    };
+
+    auto const moov = find(0, st.st_size, "moov");
+    if (!moov) return {};
+    auto found = false;
+    if (auto const mvhd = find(moov->body, moov->end, "mvhd")) {
+        tags.duration_ms = mp4_duration(fd, mvhd->body, mvhd->end);
+        found = tags.duration_ms > 0;
+    }
+    auto const udta = find(moov->body, moov->end, "udta");
+    if (!udta) return found;
+    auto const meta = find(udta->body, udta->end, "meta");
+    if (!meta) return found;
+    // 'meta' is a full atom: version and flags come before its children.
+    auto const ilst = find(meta->body + 4, meta->end, "ilst");
+    if (!ilst) return found;
+
+    // Items are walked by their headers; only the text ones are read
+    // (the cover art, 'covr', never is).
+    static constexpr std::array<string_view, 6> ITEMS{"\xA9nam", "\xA9" "ART", "aART", "\xA9" "alb", "\xA9" "day", "trkn"};
+    for (auto pos = ilst->body; pos + 8 <= ilst->end;) {
+        // Item header (8), its 'data' atom: size (4), type (4), flags (4), locale (4), value.
+        auto const header = read_at(fd, pos, 24);
+        if (header.size() < 8)
+            break;
+        auto const size = int64_t(be32(header.data()));
+        if (size < 8 || size > ilst->end - pos)
+            break;
+        string_view const name{reinterpret_cast<char const*>(&header[4]), 4};
+        if (header.size() == 24 && size >= 24
+            && string_view{reinterpret_cast<char const*>(&header[12]), 4} == "data"
+            && std::ranges::find(ITEMS, name) != ITEMS.end())
+        {
+            auto const data_size = std::min<int64_t>(be32(&header[8]), size - 8);
+            auto const value = read_at(fd, pos + 24, size_t(std::clamp<int64_t>(data_size - 16, 0, MAX_TEXT_SIZE)));
+            auto const text = [&value] {
+                return string{reinterpret_cast<char const*>(value.data()), value.size()};
+            };
+            if (name == "\xA9nam")
+                tags.title = text(), found = true;
+            else if (name == "\xA9" "ART")
+                tags.artist = text(), found = true;
+            else if (name == "aART" && tags.artist.empty())
+                tags.artist = text(), found = true;
+            else if (name == "\xA9" "alb")
+                tags.album = text(), found = true;
+            else if (name == "\xA9" "day")
+                tags.year = leading_number(text()), found = true;
+            else if (name == "trkn" && value.size() >= 4)
+                tags.track = value[2] << 8 | value[3], found = true;
+        }
+        pos += size;
+    }
+    return found;
+}
+
+/// 'mvhd' (full atom): version 0 has 32-bit times, version 1 64-bit ones.
+///   v0: version+flags (4), created (4), modified (4), timescale (4), duration (4)
+///   v1: version+flags (4), created (8), modified (8), timescale (4), duration (8)
+int64_t TagReader::mp4_duration(int const fd, int64_t const body, int64_t const end) noexcept {
+    auto const data = read_at(fd, body, size_t(std::min<int64_t>(32, end - body)));
+    if (data.empty())
+        return {};
+    uint64_t timescale{}, duration{};
+    if (data[0] == 1 && data.size() >= 32) {
+        timescale = be32(&data[20]);
+        duration = be64(&data[24]);
+    }
+    else if (data[0] == 0 && data.size() >= 20) {
+        timescale = be32(&data[12]);
+        duration = be32(&data[16]);
+    }
+    // All ones: the duration is not known.
+    if (!timescale || duration == ~uint64_t{} || duration == 0xFFFFFFFF)
+        return {};
+    return int64_t(duration * 1000 / timescale);
+}
@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/*------- TagReader:
+-------------------------------------------------------------------*/
+/// Reads tags of MP3 (ID3v2.2/2.3/2.4, then ID3v1 for what is missing)
+/// and M4A (moov/udta/meta/ilst) files. Only headers of frames/atoms
+/// and the bodies of the text ones we need are read (pread), so neither
+/// pictures in the tags nor the audio are touched.
+/// All texts are returned in UTF-8.
+/// The duration comes from the headers too: MP4 'mvhd', MP3 Xing/VBRI
+/// or the bitrate of a CBR file.
+class TagReader {
+public:
+    struct Tags {
+        std::string title{};
+        std::string artist{};
+        std::string album{};
+        int track{};
+        int year{};
+        int64_t duration_ms{};      // 0 if unknown
+
+        bool complete() const noexcept {
+            return !title.empty() && !artist.empty() && !album.empty();
+        }
+    };
+private:
+    // Longer texts are not titles (and we don't want to read them).
+    static constexpr uint32_t MAX_TEXT_SIZE{4096};
+    static constexpr int64_t MAX_UNSYNC_SIZE{1024 * 1024};
+    using Bytes = std::vector<uint8_t>;
+
+public:
+    static std::optional<Tags> read(std::string const& path) noexcept;
+
+private:
+    static bool read_id3v2(int fd, Tags& tags) noexcept;
+    static bool read_id3v1(int fd, Tags& tags) noexcept;
+    static bool read_mp4(int fd, Tags& tags) noexcept;
+    static int64_t mp4_duration(int fd, int64_t moov_body, int64_t moov_end) noexcept;
+    static void id3_frame(std::string_view id, Bytes const& body, Tags& tags) noexcept;
+    static std::string id3_text(Bytes const& body) noexcept;
+    static Bytes read_at(int fd, int64_t offset, size_t size) noexcept;
+};
@@ -0,0 +1,171 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "tag_scanner.h"
+#include "../model/song_tags.h"
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+TagScanner::~TagScanner() {
+    cancel();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                   s t a r t   &   c a n c e l                    *
+ *                                                                  *
+ *******************************************************************/
+
+void TagScanner::start(ProgressFn on_progress) {
+    cancel();
+    auto const scan = make_shared<Scan>();
+    {
+        lock_guard<mutex> lg{mutex_};
+        scan_ = scan;
+    }
+    worker_ = jthread([scan, on_progress = std::move(on_progress)] (stop_token const& token) {
+        run(token, *scan, on_progress);
+    });
+}
+
+/// A batch that comes after cancel() goes nowhere.
+void TagScanner::cancel() noexcept {
+    if (worker_.joinable()) {
+        worker_.request_stop();
+        worker_.join();
+    }
+    lock_guard<mutex> lg{mutex_};
+    scan_.reset();
+}
+
+void TagScanner::add(DirScanner::Batch const& batch) {
+    shared_ptr<Scan> scan{};
+    {
+        lock_guard<mutex> lg{mutex_};
+        scan = scan_;
+    }
+    if (scan)
+        for (auto const& listing : batch)
+            for (auto const& name : listing.files) {
+                ++scan->found;
+                if (!scan->paths.push(listing.path + '/' + name))
+                    return;
+            }
+}
+
+void TagScanner::close() {
+    lock_guard<mutex> lg{mutex_};
+    if (scan_)
+        scan_->paths.close();
+}
+
+/// Reading tags waits for the disk, not for the CPU,
+/// so we keep more requests in flight than there are cores.
+uint TagScanner::io_depth() noexcept {
+    return std::max(8u, 2 * std::thread::hardware_concurrency());
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            r u n                                 *
+ *                                                                  *
+ *******************************************************************/
+
+/// The whole pipeline lives in this function (on the scanner thread),
+/// which is also the writer stage.
+void TagScanner::run(stop_token const& token, Scan& scan, ProgressFn const& on_progress) {
+    using clock = chrono::steady_clock;
+    auto const started = clock::now();
+
+    // Stamps of what is already cached, read-only for the readers.
+    auto const cached = SongTags::stamps();
+
+    auto& paths = scan.paths;
+    BoundedQueue<SongTags> results{QUEUE_SIZE};
+    stop_callback const on_stop{token, [&] {
+        paths.abort();
+        results.abort();
+    }};
+
+    atomic<size_t> done{}, read{};
+
+    // Stage 1 - walk (the walker of the catalog tree, see add).
+    // Stage 2 - read. The last reader closes the results.
+    auto const readers_count = io_depth();
+    atomic<uint> alive{readers_count};
+    vector<jthread> readers{};
+    readers.reserve(readers_count);
+    for (uint i = 0; i < readers_count; ++i)
+        readers.emplace_back([&] {
+            while (auto path = paths.pop()) {
+                auto const stamp = SongTags::stamp(*path);
+                if (!stamp) {
+                    ++done;
+                    continue;
+                }
+                if (auto const it = cached.find(*path); it != cached.end() && it->second == *stamp) {
+                    ++done;
+                    continue;
+                }
+                ++read;
+                if (!results.push(SongTags::read(*path, *stamp)))
+                    break;
+            }
+            if (alive.fetch_sub(1) == 1)
+                results.close();
+        });
+
+    // Stage 3 - write.
+    auto progress = [&] (bool const finished) {
+        return Progress{
+            .found = scan.found.load(),
+            .done = done.load(),
+            .read = read.load(),
+            .seconds = chrono::duration<double>(clock::now() - started).count(),
+            .finished = finished
+        };
+    };
+    auto reported = clock::now();
+    vector<SongTags> batch{};
+    batch.reserve(BATCH_SIZE);
+    while (results.pop_many(batch, BATCH_SIZE, REPORT_INTERVAL)) {
+        if (!batch.empty()) {
+            SongTags::save_all(batch);
+            done += batch.size();
+            batch.clear();
+        }
+        if (on_progress && clock::now() - reported >= REPORT_INTERVAL) {
+            on_progress(progress(false));
+            reported = clock::now();
+        }
+    }
+
+    // Readers are joined when they go out of scope.
+    if (!token.stop_requested() && on_progress)
+        on_progress(progress(true));
+}
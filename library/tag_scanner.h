@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "dir_scanner.h"
+#include "../shared/bounded_queue.hh"
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <functional>
+
+/*------- TagScanner:
+-------------------------------------------------------------------*/
+/// Fills the tags cache (table 'song_tags') for the whole library in background.
+/// The work goes through a pipeline of stages connected by queues:
+///   walk  - the DirScanner which reads the library for the catalog tree
+///           hands its batches over (add, close); the library is walked once.
+///           The walk doesn't wait for the readers (paths of the whole
+///           library fit in memory), the next stages are bounded,
+///   read  - pool of I/O threads: stat, skip if the cache is valid, read the tags
+///           and the content hash,
+///   write - one thread saves the results in batches (one transaction per batch).
+/// Reading a header is a few small preads, so parsing isn't a stage of its own -
+/// the read pool is sized for I/O depth (a network disk), not for cores.
+/// Starting a new scan cancels the previous one.
+class TagScanner {
+public:
+    static constexpr size_t QUEUE_SIZE{4096};
+    static constexpr size_t BATCH_SIZE{512};
+    static constexpr std::chrono::milliseconds REPORT_INTERVAL{500};
+
+    struct Progress {
+        size_t found{};         // song files found so far
+        size_t done{};          // of them checked (read or still valid in the cache)
+        size_t read{};          // of them read from the disk
+        double seconds{};
+        bool finished{};
+
+        double files_per_second() const noexcept {
+            return seconds > 0. ? double(done) / seconds : 0.;
+        }
+    };
+    /// Called (on the scanner thread) every REPORT_INTERVAL and once at the end.
+    using ProgressFn = std::function<void(Progress const&)>;
+
+private:
+    // Paths of one scan, shared with the walker's threads.
+    struct Scan {
+        BoundedQueue<std::string> paths{std::numeric_limits<size_t>::max()};
+        std::atomic<size_t> found{};
+    };
+    std::mutex mutex_{};
+    std::shared_ptr<Scan> scan_{};
+    std::jthread worker_{};
+public:
+    TagScanner() = default;
+    ~TagScanner();
+    TagScanner(TagScanner const&) = delete;
+    TagScanner& operator=(TagScanner const&) = delete;
+    TagScanner(TagScanner&&) = delete;
+    TagScanner& operator=(TagScanner&&) = delete;
+
+    /// Start (in background) a new scan, songs come with add().
+    void start(ProgressFn on_progress);
+    /// Song files of the batch (from the walker's threads).
+    void add(DirScanner::Batch const& batch);
+    /// The walk is finished, no more songs will come.
+    void close();
+    /// Stop the running scan and wait for its threads.
+    void cancel() noexcept;
+
+    /// Number of read threads.
+    static uint io_depth() noexcept;
+
+private:
+    static void run(std::stop_token const& token, Scan& scan, ProgressFn const& on_progress);
+};
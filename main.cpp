@@ -6,6 +6,12 @@
 #include "mainwindow.h"
 #include "model/playlist.h"
 #include "model/song.h"
+#include "model/dir_content.h"
+#include "model/song_tags.h"
+#include "model/song_loudness.h"
+#include "model/song_waveform.h"
+#include "model/song_fingerprint.h"
+#include "model/song_tempo.h"
 #include <iostream>
 #include "tool.h"
 
@@ -16,6 +22,17 @@ bool create_commands(SQLite const& db) {
     return Playlist::create_table() && Song::create_table();
 }
 
+// Tables added after the first release (created if they don't exist).
+bool upgrade_commands() {
+    return Song::upgrade_table()
+        && DirContent::create_table()
+        && SongTags::create_table()
+        && SongLoudness::create_table()
+        && SongWaveform::create_table()
+        && SongFingerprint::create_table()
+        && SongTempo::create_table();
+}
+
 bool open_or_create_database() {
     auto const database_dir = tool::home_dir() + '/' + ".beesoft";
     if (tool::create_dirs(database_dir)) {
@@ -23,10 +40,10 @@ bool open_or_create_database() {
 
         // Try to open database.
         if (SQLite::self().open(database_path))
-            return true;
+            return upgrade_commands();
 
         return SQLite::self().create(database_path, [] (SQLite const& db) {
-            return create_commands(db);
+            return create_commands(db) && upgrade_commands();
         }, false);
     }
     return {};
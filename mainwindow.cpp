@@ -3,6 +3,8 @@
 #include "workspace.h"
 #include "progress.h"
 #include "tool.h"
+#include "shared/event.hh"
+#include "shared/event_controller.hh"
 #include <QIcon>
 #include <QMenu>
 #include <QAction>
@@ -75,6 +77,37 @@ Window::Window(): QDialog(),
 
     tray_->show();
     tool::resize(this, 60, 60);
+
+    EventController::self().append(this,
+        event::TagScanProgress,
+        event::TagScanFinished);
+}
+
+Window::~Window() {
+    EventController::self().remove(this);
+}
+
+// Progress of the background tags scan is shown in the tray tooltip.
+void Window::customEvent(QEvent* const event) {
+    auto const e = dynamic_cast<Event*>(event);
+    auto const data = e->data();
+    if (data.size() != 3)
+        return;
+    auto const done = data[0].toULongLong();
+    auto const found = data[1].toULongLong();
+    auto const files_per_second = data[2].toDouble();
+
+    switch (int(e->type())) {
+    case event::TagScanProgress:
+        tray_->setToolTip(QString("Amadeus\nReading tags: %1 of %2 songs\n%3 files/s")
+            .arg(done)
+            .arg(found)
+            .arg(files_per_second, 0, 'f', 0));
+        break;
+    case event::TagScanFinished:
+        tray_->setToolTip("Amadeus");
+        break;
+    }
 }
 
 void Window::setVisible(bool const visible) {
@@ -10,6 +10,7 @@
 class QMenu;
 class QLabel;
 class QAction;
+class QEvent;
 class ControlBar;
 class Workspace;
 class Progress;
@@ -33,8 +34,10 @@ class Window : public QDialog {
     bool first_time_{true};
 public:
     Window();
+    ~Window() override;
     void setVisible(bool visible) override;
 private:
+    void customEvent(QEvent*) override;
     void closeEvent(QCloseEvent*) override;
     void showEvent(QShowEvent*) override;
     void show_message();
@@ -0,0 +1,97 @@
+#include "dir_content.h"
+#include "../sqlite/sqlite.h"
+#include <filesystem>
+#include <algorithm>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+using namespace std;
+
+DirContent::DirContent(Row&& row) {
+    if (auto const f = row["path"])
+        path_ = f->value().value<std::string>();
+    if (auto const f = row["inode"])
+        inode_ = f->value().value<i64>();
+    if (auto const f = row["mtime"])
+        mtime_ = f->value().value<i64>();
+    if (auto const f = row["files"]; f && !f->value().is_null())
+        files_ = unpack(f->value().value<std::vector<u8>>());
+}
+
+bool DirContent::save() const noexcept {
+    static auto const query{"INSERT OR REPLACE INTO dir_content (path, inode, mtime, files) VALUES(?,?,?,?)"s};
+    return SQLite::self().exec(query, path_, inode_, mtime_, pack(files_));
+}
+
+bool DirContent::create_table() noexcept {
+    return SQLite::self().exec(CreateDirContentCmd);
+}
+
+auto DirContent::for_path(string const& path) noexcept
+-> optional<DirContent> {
+    static auto const query{"SELECT * FROM dir_content WHERE path=?"s};
+    if (auto const result = SQLite::self().select(query, path))
+        if (result->size() == 1)
+            return DirContent(result.value()[0]);
+    return {};
+}
+
+auto DirContent::remove(string const& path) noexcept
+-> bool {
+    return SQLite::self().exec("DELETE FROM dir_content WHERE path=?", path);
+}
+
+auto DirContent::songs_in(string const& dir) noexcept
+-> vector<string> {
+    struct stat st{};
+    if (::stat(dir.c_str(), &st) != 0)
+        return {};
+    auto const inode = static_cast<i64>(st.st_ino);
+    auto const mtime = static_cast<i64>(st.st_mtim.tv_sec) * 1'000'000'000 + st.st_mtim.tv_nsec;
+
+    if (auto cached = for_path(dir); cached && cached->inode_ == inode && cached->mtime_ == mtime)
+        return std::move(cached->files_);
+
+    // The type of entry is taken from the directory entry (d_type),
+    // stat is called only for symbolic links.
+    vector<string> files{};
+    error_code ec{};
+    fs::directory_iterator it{dir, fs::directory_options::skip_permission_denied, ec};
+    if (ec) return {};
+    for (fs::directory_iterator const end{}; it != end; it.increment(ec)) {
+        if (ec) break;
+        auto name = it->path().filename().string();
+        if (is_song(name) && it->is_regular_file(ec))
+            files.push_back(std::move(name));
+    }
+    std::ranges::sort(files, [] (string const& a, string const& b) {
+        return std::ranges::lexicographical_compare(a, b, [] (unsigned char const x, unsigned char const y) {
+            return tolower(x) < tolower(y);
+        });
+    });
+
+    DirContent{dir, inode, mtime, files}.save();
+    return files;
+}
+
+/// Names are stored as one blob, separated with zero.
+auto DirContent::pack(vector<string> const& names) noexcept
+-> vector<u8> {
+    vector<u8> data{};
+    for (auto const& name : names) {
+        data.insert(data.end(), name.begin(), name.end());
+        data.push_back(0);
+    }
+    return data;
+}
+
+auto DirContent::unpack(vector<u8> const& data) noexcept
+-> vector<string> {
+    vector<string> names{};
+    auto first = data.begin();
+    for (auto it = first; it != data.end(); ++it)
+        if (*it == 0) {
+            names.emplace_back(first, it);
+            first = it + 1;
+        }
+    return names;
+}
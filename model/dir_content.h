@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../sqlite/row.h"
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/// Cached list of songs in the directory (table 'dir_content').
+/// The entry is valid as long as the directory has the same inode
+/// and mtime (mtime of directory changes when a file is created,
+/// removed or renamed in it). So checking of the cache costs one stat
+/// instead of reading the directory and stat for every file in it.
+class DirContent {
+    using i64 = int64_t;
+    inline static std::string const CreateDirContentCmd = R"(
+        CREATE TABLE IF NOT EXISTS dir_content (
+            path TEXT PRIMARY KEY,
+            inode INTEGER NOT NULL,
+            mtime INTEGER NOT NULL,
+            files BLOB
+        )
+    )";
+
+    std::string path_{};
+    i64 inode_{};
+    i64 mtime_{};       // nanoseconds
+    std::vector<std::string> files_{};
+
+public:
+    static constexpr std::array<std::string_view, 2> SONG_EXTENSIONS{".m4a", ".mp3"};
+
+    explicit DirContent(Row&&);
+    DirContent(std::string path, i64 inode, i64 mtime, std::vector<std::string> files) :
+        path_{std::move(path)}, inode_{inode}, mtime_{mtime}, files_{std::move(files)} {}
+    bool save() const noexcept;
+
+    std::vector<std::string> const& files() const noexcept {
+        return files_;
+    }
+
+    static bool create_table() noexcept;
+    static std::optional<DirContent> for_path(std::string const& path) noexcept;
+    static bool remove(std::string const& path) noexcept;
+
+    /// Names of songs in the directory (sorted). From the cache if it is still valid,
+    /// otherwise the directory is read (and the cache updated).
+    static std::vector<std::string> songs_in(std::string const& dir) noexcept;
+
+    static bool is_song(std::string_view const name) noexcept {
+        if (name.empty() || name[0] == '.')
+            return {};
+        for (auto const ext : SONG_EXTENSIONS)
+            if (name.ends_with(ext))
+                return true;
+        return {};
+    }
+
+private:
+    static std::vector<u8> pack(std::vector<std::string> const& names) noexcept;
+    static std::vector<std::string> unpack(std::vector<u8> const& data) noexcept;
+};
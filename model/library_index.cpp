@@ -0,0 +1,48 @@
+#include "library_index.h"
+#include <algorithm>
+using namespace std;
+
+/// Apply changes reported by the watcher.
+/// Only directories which were already read are updated, the new directory
+/// is added to its parent, but its own content stays unknown (until somebody reads it).
+void LibraryIndex::apply(vector<string> const& created_dirs, vector<string> const& removed_dirs) noexcept {
+    auto split = [] (string const& path) -> pair<string, string> {
+        auto const idx = path.rfind('/');
+        if (idx == string::npos)
+            return {};
+        return {path.substr(0, idx), path.substr(idx + 1)};
+    };
+
+    lock_guard<mutex> lg{mutex_};
+    for (auto const& path : removed_dirs) {
+        erase_if(subdirs_, [&path] (auto const& item) {
+            auto const& dir = item.first;
+            return dir.starts_with(path) && (dir.size() == path.size() || dir[path.size()] == '/');
+        });
+        auto const [parent, name] = split(path);
+        if (auto const it = subdirs_.find(parent); it != subdirs_.end())
+            erase(it->second, name);
+    }
+    for (auto const& path : created_dirs) {
+        auto const [parent, name] = split(path);
+        if (auto const it = subdirs_.find(parent); it != subdirs_.end())
+            if (ranges::find(it->second, name) == it->second.end())
+                it->second.push_back(name);
+    }
+}
+
+auto LibraryIndex::subdirs(string const& dir) const noexcept
+-> optional<vector<string>> {
+    lock_guard<mutex> lg{mutex_};
+    if (auto const it = subdirs_.find(dir); it != subdirs_.end())
+        return it->second;
+    return {};
+}
+
+auto LibraryIndex::has_subdirs(string const& dir) const noexcept
+-> optional<bool> {
+    lock_guard<mutex> lg{mutex_};
+    if (auto const it = subdirs_.find(dir); it != subdirs_.end())
+        return !it->second.empty();
+    return {};
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../library/dir_scanner.h"
+#include <mutex>
+#include <string>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+
+/// In-memory index of the music library directories (directory -> its subdirectories).
+/// It is filled in background by the scanner and read by the catalog tree,
+/// when it needs children of the expanded directory.
+/// The directory which was not read yet is not present in the index.
+class LibraryIndex {
+    std::unordered_map<std::string, std::vector<std::string>> subdirs_{};
+    mutable std::mutex mutex_{};
+public:
+    static LibraryIndex& self() noexcept {
+        static auto obj = LibraryIndex();
+        return obj;
+    }
+    LibraryIndex(LibraryIndex const&) = delete;
+    LibraryIndex& operator=(LibraryIndex const&) = delete;
+    LibraryIndex(LibraryIndex&&) = delete;
+    LibraryIndex& operator=(LibraryIndex&&) = delete;
+    ~LibraryIndex() = default;
+
+    void add(DirScanner::Listing&& listing) noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        subdirs_.insert_or_assign(std::move(listing.path), std::move(listing.subdirs));
+    }
+    void add(DirScanner::Batch&& batch) noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        for (auto&& listing : batch)
+            subdirs_.insert_or_assign(std::move(listing.path), std::move(listing.subdirs));
+    }
+    void clear() noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        subdirs_.clear();
+    }
+    size_t size() const noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        return subdirs_.size();
+    }
+
+    void apply(std::vector<std::string> const& created_dirs, std::vector<std::string> const& removed_dirs) noexcept;
+    std::optional<std::vector<std::string>> subdirs(std::string const& dir) const noexcept;
+    std::optional<bool> has_subdirs(std::string const& dir) const noexcept;
+
+private:
+    LibraryIndex() = default;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+/// Interned paths of songs. Every path gets its own small, dense id,
+/// so sets of songs can be kept as bitmaps of ids. A released id
+/// (nobody refers to the path any more) is given to the next new path.
+class PathPool {
+public:
+    using Id = uint32_t;
+private:
+    std::vector<QString> paths_{};
+    std::unordered_map<QString, Id> ids_{};
+    std::vector<Id> free_{};
+    mutable std::mutex mutex_{};
+public:
+    static PathPool& self() noexcept {
+        static auto obj = PathPool();
+        return obj;
+    }
+    PathPool(PathPool const&) = delete;
+    PathPool& operator=(PathPool const&) = delete;
+    PathPool(PathPool&&) = delete;
+    PathPool& operator=(PathPool&&) = delete;
+    ~PathPool() = default;
+
+    /// Id of the path (the path is added if it is not known yet).
+    Id intern(QString const& path) noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        if (auto const it = ids_.find(path); it != ids_.end())
+            return it->second;
+        Id id{};
+        if (free_.empty()) {
+            id = Id(paths_.size());
+            paths_.push_back(path);
+        }
+        else {
+            id = free_.back();
+            free_.pop_back();
+            paths_[id] = path;
+        }
+        ids_.emplace(path, id);
+        return id;
+    }
+    /// The id is no longer used, it may go to another path.
+    void release(Id const id) noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        if (id >= paths_.size() || !ids_.erase(paths_[id]))
+            return;
+        paths_[id] = QString{};
+        free_.push_back(id);
+    }
+    /// Id of the path, but only if the path is already known.
+    std::optional<Id> find(QString const& path) const noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        if (auto const it = ids_.find(path); it != ids_.end())
+            return it->second;
+        return {};
+    }
+    QString path(Id const id) const noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        return paths_[id];
+    }
+    QStringList paths(std::vector<Id> const& ids) const noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        QStringList lista{};
+        lista.reserve(ids.size());
+        for (auto const id : ids)
+            lista << paths_[id];
+        return lista;
+    }
+    size_t size() const noexcept {
+        std::lock_guard<std::mutex> lg{mutex_};
+        return ids_.size();
+    }
+
+private:
+    PathPool() = default;
+};
@@ -4,8 +4,42 @@
 #include "../shared/event_controller.hh"
 #include <iostream>
 #include <format>
+#include <algorithm>
 using namespace std;
 
+auto Selection::snapshot() noexcept
+-> SnapshotPtr {
+    if (auto snapshot = snapshot_.load())
+        return snapshot;
+
+    // We keep the shared lock until the new snapshot is published,
+    // so no change can slip in between (it would be lost).
+    shared_lock<shared_mutex> lock{mutex_};
+    if (auto snapshot = snapshot_.load())
+        return snapshot;
+
+    vector<PathPool::Id> ids{};
+    ids.reserve(data_.count());
+    data_.for_each(true, [&ids] (size_t const id) {
+        ids.push_back(PathPool::Id(id));
+    });
+    // Ordered by the bytes of the paths (UTF-8), as the selection always was.
+    auto const unsorted = PathPool::self().paths(ids);
+    vector<pair<string, qsizetype>> keys{};
+    keys.reserve(size_t(unsorted.size()));
+    for (qsizetype i = 0; i < unsorted.size(); ++i)
+        keys.emplace_back(unsorted[i].toStdString(), i);
+    std::ranges::sort(keys);
+    QStringList paths{};
+    paths.reserve(unsorted.size());
+    for (auto const& [key, i] : keys)
+        paths << unsorted[i];
+
+    auto snapshot = make_shared<Snapshot const>(Snapshot{version_, std::move(paths)});
+    snapshot_.store(snapshot);
+    return snapshot;
+}
+
 
 bool Selection::save_as_playlist(string&& name) noexcept {
     if (empty()) {
@@ -24,8 +58,8 @@ bool Selection::save_as_playlist(string&& name) noexcept {
         return {};
     }
 
-    for (auto const& it : data_)
-        if (!Song(playlist.id(), it).save())
+    for (auto const& path : to_list())
+        if (!Song(playlist.id(), path.toStdString()).save())
             return {};
 
     EventController::self().send(event::NewPlaylistAdded, QString::fromStdString(playlist_name));
@@ -1,18 +1,40 @@
 #pragma once
 
+#include "path_pool.h"
+#include "../shared/bit_vector.hh"
 #include "../shared/event.hh"
 #include "../shared/event_controller.hh"
-#include <set>
 #include <string>
-// #include <string_view>
 #include <QStringList>
+#include <shared_mutex>
+#include <memory>
+#include <atomic>
 #include <mutex>
 #include <QString>
 
+/// Songs selected by the user.
+/// We keep a bitmap of interned path ids (see PathPool),
+/// so insert/erase/contains don't allocate and don't convert paths.
+/// Only selected paths are interned, the id of an unselected one is released.
+/// Every change is announced with one SelectionChanged event
+/// (also a change of many songs at once, see insert_many/erase_many).
+/// Readers share the lock, only changes take it exclusively.
 class Selection : QObject {
     Q_OBJECT
-    std::set<std::string> data_{};
-    std::mutex mutex_{};
+public:
+    /// Immutable state of the selection. Every change gets a new version,
+    /// so a reader can skip its work if it already has seen this version.
+    struct Snapshot {
+        uint64_t version{};
+        QStringList paths{};    // sorted
+    };
+    using SnapshotPtr = std::shared_ptr<Snapshot const>;
+private:
+    BitVector data_{};
+    uint64_t version_{};
+    std::shared_mutex mutex_{};
+    // Built on demand, dropped on every change.
+    std::atomic<SnapshotPtr> snapshot_{};
 public:
     static Selection& self() noexcept {
         static auto obj = Selection();
@@ -25,52 +47,104 @@ public:
     ~Selection() = default;
 
     void insert(QString const& path) noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        data_.insert(path.toStdString());
+        if (std::unique_lock<std::shared_mutex> lock{mutex_}; !set(PathPool::self().intern(path), true))
+            return;
         EventController::self().send(event::SelectionChanged);
     }
     void erase(QString const& path) noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        data_.erase(path.toStdString());
+        if (std::unique_lock<std::shared_mutex> lock{mutex_}; !unset(path))
+            return;
+        EventController::self().send(event::SelectionChanged);
+    }
+    /// The file was renamed/moved, its selection goes with it.
+    void rename(QString const& from, QString const& to) noexcept {
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex_};
+            if (!unset(from))
+                return;
+            set(PathPool::self().intern(to), true);
+        }
         EventController::self().send(event::SelectionChanged);
     }
+    void insert_many(QStringList const& paths) noexcept {
+        auto changed = false;
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex_};
+            for (auto const& path : paths)
+                changed |= set(PathPool::self().intern(path), true);
+        }
+        if (changed)
+            EventController::self().send(event::SelectionChanged);
+    }
+    void erase_many(QStringList const& paths) noexcept {
+        auto changed = false;
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex_};
+            for (auto const& path : paths)
+                changed |= unset(path);
+        }
+        if (changed)
+            EventController::self().send(event::SelectionChanged);
+    }
     bool contains(QString const& path) noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        return data_.contains(path.toStdString());
+        // Under the lock: the id can't be released and given to another path.
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+        auto const id = PathPool::self().find(path);
+        return id && *id < data_.size() && data_.test(*id);
     }
     bool empty() noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        return data_.empty();
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+        return data_.none();
     }
     size_t size() noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        return data_.size();
+        std::shared_lock<std::shared_mutex> lock{mutex_};
+        return data_.count();
     }
     void clear() noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        data_.clear();
+        {
+            std::unique_lock<std::shared_mutex> lock{mutex_};
+            data_.for_each(true, [] (size_t const id) {
+                PathPool::self().release(PathPool::Id(id));
+            });
+            data_.fill(false);
+            changed();
+        }
         EventController::self().send(event::SelectionChanged);
     }
 
+    /// Current state of the selection (O(1) if nothing has changed since the last call).
+    SnapshotPtr snapshot() noexcept;
+
+    /// Selected paths, sorted (shared with the snapshot, no copy).
     QStringList to_list() noexcept {
-        std::lock_guard<std::mutex> lg{mutex_};
-        QStringList lista{};
-        lista.reserve(data_.size());
-        std::ranges::for_each(data_, [&lista] (auto const element) {
-            lista << QString::fromStdString(element);
-        });
-        return lista;
+        return snapshot()->paths;
     }
 
     bool save_as_playlist(std::string&& name) noexcept;
 
-    using iterator = std::set<std::string>::iterator;
-    using const_iterator = std::set<std::string>::const_iterator;
-    iterator begin() { return data_.begin(); }
-    iterator end() { return data_.end(); }
-    const_iterator cbegin() { return data_.cbegin(); }
-    const_iterator cend() { return data_.cend(); }
-
 private:
     Selection() = default;
+
+    // mutex_ must be locked exclusively.
+    bool set(PathPool::Id const id, bool const value) noexcept {
+        if (id >= data_.size()) {
+            if (!value) return {};
+            data_.resize(std::max<size_t>(id + 1, 2 * data_.size()));
+        }
+        if (!data_.set(id, value))
+            return {};
+        changed();
+        return true;
+    }
+    bool unset(QString const& path) noexcept {
+        auto const id = PathPool::self().find(path);
+        if (!id || !set(*id, false))
+            return {};
+        PathPool::self().release(*id);
+        return true;
+    }
+    void changed() noexcept {
+        ++version_;
+        snapshot_.store(nullptr);
+    }
 };
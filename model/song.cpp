@@ -1,4 +1,5 @@
 #include "song.h"
+#include "song_tags.h"
 #include "../sqlite/sqlite.h"
 using namespace std;
 
@@ -9,12 +10,16 @@ Song::Song(Row&& row) {
         pid_ = f->value().value<i64>();
     if (auto const f = row["path"])
         path_ = f->value().value<std::string>();
+    if (auto const f = row["hash"]; f && !f->value().is_null())
+        hash_ = f->value().value<int64_t>();
 }
 
 
 bool Song::insert() noexcept {
-    static auto const query{"INSERT INTO song (pid, path) VALUES(?,?)"s};
-    if (auto const id = SQLite::self().insert(query, pid_, path_); id > 0) {
+    static auto const query{"INSERT INTO song (pid, path, hash) VALUES(?,?,?)"s};
+    if (!hash_)
+        hash_ = SongTags::of(path_).hash();
+    if (auto const id = SQLite::self().insert(query, pid_, path_, hash_); id > 0) {
         id_ = id;
         return true;
     }
@@ -22,8 +27,8 @@ bool Song::insert() noexcept {
 }
 
 bool Song::update() const noexcept {
-    static auto const query{"UPDATE song SET pid=?, path=? WHERE id=?"s};
-    return SQLite::self().update(query, pid_, path_, id_);
+    static auto const query{"UPDATE song SET pid=?, path=?, hash=? WHERE id=?"s};
+    return SQLite::self().update(query, pid_, path_, hash_, id_);
 }
 
 
@@ -34,6 +39,14 @@ bool Song::create_table() noexcept {
     return true;
 }
 
+bool Song::upgrade_table() noexcept {
+    static auto const query{"SELECT COUNT(*) AS count FROM pragma_table_info('song') WHERE name='hash'"s};
+    if (auto result = SQLite::self().select(query); result && result->size() == 1)
+        if (auto const f = result.value()[0]["count"]; f && f->value().value<i64>() == 0)
+            return SQLite::self().exec("ALTER TABLE song ADD COLUMN hash INTEGER"s);
+    return true;
+}
+
 auto Song::with_id(i64 id) noexcept
     -> std::optional<Song> {
     static auto const query{"SELECT * FROM song WHERE id=?"s};
@@ -70,7 +83,55 @@ auto Song::all_for(i64 const pid) noexcept
     return {};
 }
 
+/// Only paths of songs in the playlist (without creating Song objects).
+auto Song::qpaths_for(i64 const pid) noexcept
+    -> QStringList {
+    QStringList paths{};
+
+    static auto const query{"SELECT path FROM song WHERE pid=?"s};
+    if (auto result = SQLite::self().select(query, pid)) {
+        paths.reserve(result->size());
+        for (auto&& row : result.value())
+            if (auto const f = row["path"])
+                paths << QString::fromStdString(f->value().value<std::string>());
+    }
+    return paths;
+}
+
 auto Song::remove(i64 const id) noexcept
     -> bool {
     return SQLite::self().exec("DELETE FROM playlist WHERE id=?", id);
 }
+
+/// Called when the tags cache is up to date (after the tag scan).
+/// A file is looked for only once per path, not per playlist.
+/// A playlist which already has the new path loses the old entry.
+size_t Song::relink() noexcept {
+    auto const& db = SQLite::self();
+    // Hashes of the songs added before hashes (the files still in their places).
+    (void)db.exec("UPDATE song SET hash=(SELECT t.hash FROM song_tags t WHERE t.path=song.path) WHERE hash IS NULL OR hash=0"s);
+
+    size_t relinked{};
+    auto result = db.select("SELECT DISTINCT path, hash FROM song WHERE hash IS NOT NULL AND hash<>0"s);
+    if (!result)
+        return relinked;
+    db.transaction([&] {
+        for (auto&& row : result.value()) {
+            auto const path = row["path"];
+            auto const hash = row["hash"];
+            if (!path || !hash)
+                continue;
+            auto const old_path = path->value().value<std::string>();
+            if (SongTags::stamp(old_path))
+                continue;
+            if (auto const new_path = SongTags::path_for_hash(hash->value().value<int64_t>())) {
+                if (!db.exec("UPDATE OR IGNORE song SET path=? WHERE path=?"s, *new_path, old_path)
+                    || !db.exec("DELETE FROM song WHERE path=?"s, old_path))
+                    return false;
+                ++relinked;
+            }
+        }
+        return true;
+    });
+    return relinked;
+}
@@ -2,10 +2,13 @@
 
 #include "../sqlite/row.h"
 #include <QString>
+#include <QStringList>
 #include <string>
 #include <vector>
 #include <cstdint>
 
+/// Song of a playlist. Besides the path it keeps the content hash of the file
+/// (see SongTags), so when the file is moved the song can be found again.
 class Song {
     using i64 = uint64_t;
     inline static std::vector<std::string> const CreateSongsCmd{
@@ -26,6 +29,7 @@ class Song {
     i64 id_{};
     i64 pid_;   // playlist id
     std::string path_;
+    int64_t hash_{};    // 0 if unknown
 
 public:
     explicit Song(Row&&);
@@ -39,8 +43,15 @@ public:
     }
 
     static bool create_table() noexcept;
+    /// Columns added after the first release.
+    static bool upgrade_table() noexcept;
     static std::optional<Song> with_id(i64 id) noexcept;
     static std::vector<Song> for_pid(i64 pid) noexcept;
     static std::vector<Song> all_for(i64 pid) noexcept;
+    static QStringList qpaths_for(i64 pid) noexcept;
     static bool remove(i64 id) noexcept;
+    /// Songs whose files no longer exist get the paths of files with
+    /// the same content (moved or renamed), songs without hashes get them.
+    /// Returns the number of paths changed.
+    static size_t relink() noexcept;
 };
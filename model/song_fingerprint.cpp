@@ -0,0 +1,118 @@
+#include "song_fingerprint.h"
+#include "../sqlite/sqlite.h"
+using namespace std;
+
+bool SongFingerprint::create_table() noexcept {
+    auto const& db = SQLite::self();
+    return db.exec(CreateSongFingerprintCmd)
+        && db.exec(CreateFingerprintBandCmd)
+        && db.exec(CreateFingerprintBandIndexCmd)
+        && db.exec(CreateFingerprintBandPathIndexCmd)
+        && db.exec(CreateSongDuplicateCmd)
+        && db.exec(CreateSongDuplicateOtherIndexCmd);
+}
+
+auto SongFingerprint::pending() noexcept
+-> vector<string> {
+    static auto const query{R"(
+        SELECT t.path FROM song_tags t
+        LEFT JOIN song_fingerprint f ON f.path=t.path AND f.mtime=t.mtime AND f.size=t.size
+        LEFT JOIN song_tempo m ON m.path=t.path AND m.mtime=t.mtime AND m.size=t.size
+        WHERE f.path IS NULL OR m.path IS NULL
+    )"s};
+    vector<string> paths{};
+    if (auto result = SQLite::self().select(query)) {
+        paths.reserve(result->size());
+        for (auto&& row : result.value())
+            if (auto const f = row["path"])
+                paths.push_back(f->value().value<std::string>());
+    }
+    return paths;
+}
+
+bool SongFingerprint::save(string const& path, SongTags::Stamp const stamp, Fingerprint const& fingerprint) noexcept {
+    static auto const insert_fingerprint{"INSERT OR REPLACE INTO song_fingerprint (path, mtime, size, data) VALUES(?,?,?,?)"s};
+    static auto const insert_band{"INSERT INTO fingerprint_band (band, key, path) VALUES(?,?,?)"s};
+    static auto const insert_duplicate{"INSERT OR IGNORE INTO song_duplicate (path, other) VALUES(?,?)"s};
+
+    auto const& db = SQLite::self();
+    return db.transaction([&] {
+        if (!db.exec("DELETE FROM fingerprint_band WHERE path=?"s, path)
+            || !db.exec("DELETE FROM song_duplicate WHERE path=? OR other=?"s, path, path)
+            || !db.exec(insert_fingerprint, path, stamp.mtime, stamp.size, fingerprint.to_blob()))
+            return false;
+        if (fingerprint.empty())
+            return true;
+
+        // Songs sharing at least one band key are the candidates.
+        auto const bands = fingerprint.bands();
+        string query{"SELECT DISTINCT f.path, f.data FROM fingerprint_band b JOIN song_fingerprint f ON f.path=b.path WHERE "};
+        vector<Value> values{};
+        values.reserve(2 * bands.size());
+        for (size_t band = 0; band < bands.size(); ++band) {
+            if (!db.exec(insert_band, band, bands[band], path))
+                return false;
+            query += band ? " OR (b.band=? AND b.key=?)" : "(b.band=? AND b.key=?)";
+            values.emplace_back(band);
+            values.emplace_back(bands[band]);
+        }
+
+        if (auto result = db.select(Query{std::move(query), std::move(values)}))
+            for (auto&& row : result.value()) {
+                auto const other = row["path"];
+                auto const data = row["data"];
+                if (!other || !data)
+                    continue;
+                auto const other_path = other->value().value<std::string>();
+                if (other_path == path)
+                    continue;
+                if (fingerprint.same_recording(Fingerprint::from_blob(data->value().value<vector<u8>>())))
+                    if (!db.exec(insert_duplicate, path, other_path) || !db.exec(insert_duplicate, other_path, path))
+                        return false;
+            }
+        return true;
+    });
+}
+
+size_t SongFingerprint::purge() noexcept {
+    vector<string> gone{};
+    if (auto result = SQLite::self().select("SELECT path FROM song_fingerprint"s))
+        for (auto&& row : result.value())
+            if (auto const f = row["path"])
+                if (auto path = f->value().value<std::string>(); !SongTags::stamp(path))
+                    gone.push_back(std::move(path));
+    if (gone.empty())
+        return 0;
+
+    auto const& db = SQLite::self();
+    auto const ok = db.transaction([&] {
+        for (auto const& path : gone)
+            if (!db.exec("DELETE FROM fingerprint_band WHERE path=?"s, path)
+                || !db.exec("DELETE FROM song_duplicate WHERE path=? OR other=?"s, path, path)
+                || !db.exec("DELETE FROM song_fingerprint WHERE path=?"s, path))
+                return false;
+        return true;
+    });
+    return ok ? gone.size() : 0;
+}
+
+auto SongFingerprint::duplicates_of(string const& path) noexcept
+-> vector<string> {
+    static auto const query{"SELECT other FROM song_duplicate WHERE path=? ORDER BY other"s};
+    vector<string> paths{};
+    if (auto result = SQLite::self().select(query, path))
+        for (auto&& row : result.value())
+            if (auto const f = row["other"])
+                paths.push_back(f->value().value<std::string>());
+    return paths;
+}
+
+auto SongFingerprint::with_duplicates() noexcept
+-> unordered_set<string> {
+    unordered_set<string> paths{};
+    if (auto result = SQLite::self().select("SELECT DISTINCT path FROM song_duplicate"s))
+        for (auto&& row : result.value())
+            if (auto const f = row["path"])
+                paths.insert(f->value().value<std::string>());
+    return paths;
+}
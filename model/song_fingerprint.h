@@ -0,0 +1,60 @@
+#pragma once
+
+#include "song_tags.h"
+#include "../audio/fingerprint.h"
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+/// Acoustic fingerprints of the songs (table 'song_fingerprint') and what they
+/// found: LSH keys of every fingerprint in 'fingerprint_band' (one row per band)
+/// and pairs of copies of the same recording in 'song_duplicate' (both ways).
+/// Like the tags, a fingerprint is valid as long as the file has the same mtime and size.
+class SongFingerprint {
+    inline static std::string const CreateSongFingerprintCmd = R"(
+        CREATE TABLE IF NOT EXISTS song_fingerprint (
+            path TEXT PRIMARY KEY,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            data BLOB NOT NULL
+        )
+    )";
+    inline static std::string const CreateFingerprintBandCmd = R"(
+        CREATE TABLE IF NOT EXISTS fingerprint_band (
+            band INTEGER NOT NULL,
+            key INTEGER NOT NULL,
+            path TEXT NOT NULL
+        )
+    )";
+    inline static std::string const CreateFingerprintBandIndexCmd = R"(
+        CREATE INDEX IF NOT EXISTS fingerprint_band_key ON fingerprint_band (band, key)
+    )";
+    inline static std::string const CreateFingerprintBandPathIndexCmd = R"(
+        CREATE INDEX IF NOT EXISTS fingerprint_band_path ON fingerprint_band (path)
+    )";
+    inline static std::string const CreateSongDuplicateCmd = R"(
+        CREATE TABLE IF NOT EXISTS song_duplicate (
+            path TEXT NOT NULL,
+            other TEXT NOT NULL,
+            PRIMARY KEY (path, other)
+        )
+    )";
+    inline static std::string const CreateSongDuplicateOtherIndexCmd = R"(
+        CREATE INDEX IF NOT EXISTS song_duplicate_other ON song_duplicate (other)
+    )";
+public:
+    static bool create_table() noexcept;
+    /// Songs from the tags cache without a valid fingerprint
+    /// (or tempo, which is made from the same window, see SongTempo).
+    static std::vector<std::string> pending() noexcept;
+    /// Save the fingerprint and its keys, and pair the song with the copies
+    /// the keys point to (if the fingerprints really match).
+    /// An empty fingerprint (too short song) is saved too, so it is not made again.
+    static bool save(std::string const& path, SongTags::Stamp stamp, Fingerprint const& fingerprint) noexcept;
+    /// Forget the songs whose files no longer exist, returns how many.
+    static size_t purge() noexcept;
+    /// Other copies of the song.
+    static std::vector<std::string> duplicates_of(std::string const& path) noexcept;
+    /// All songs which have at least one copy.
+    static std::unordered_set<std::string> with_duplicates() noexcept;
+};
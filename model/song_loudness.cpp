@@ -0,0 +1,57 @@
+#include "song_loudness.h"
+#include "../sqlite/sqlite.h"
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+SongLoudness::SongLoudness(Row&& row) {
+    if (auto const f = row["path"])
+        path_ = f->value().value<std::string>();
+    if (auto const f = row["mtime"])
+        stamp_.mtime = f->value().value<i64>();
+    if (auto const f = row["size"])
+        stamp_.size = f->value().value<i64>();
+    if (auto const f = row["track_lufs"])
+        track_lufs_ = f->value().value<double>();
+    if (auto const f = row["track_peak"])
+        track_peak_ = f->value().value<double>();
+    if (auto const f = row["album_lufs"])
+        album_lufs_ = f->value().value<double>();
+    if (auto const f = row["album_peak"])
+        album_peak_ = f->value().value<double>();
+}
+
+bool SongLoudness::save() const noexcept {
+    static auto const query{"INSERT OR REPLACE INTO song_loudness (path, mtime, size, track_lufs, track_peak, album_lufs, album_peak) VALUES(?,?,?,?,?,?,?)"s};
+    return SQLite::self().exec(query, path_, stamp_.mtime, stamp_.size, track_lufs_, track_peak_, album_lufs_, album_peak_);
+}
+
+bool SongLoudness::create_table() noexcept {
+    return SQLite::self().exec(CreateSongLoudnessCmd);
+}
+
+auto SongLoudness::for_path(string const& path) noexcept
+-> optional<SongLoudness> {
+    static auto const query{"SELECT * FROM song_loudness WHERE path=?"s};
+    if (auto result = SQLite::self().select(query, path); result && result->size() == 1) {
+        SongLoudness loudness(result.value()[0]);
+        if (auto const stamp = SongTags::stamp(path); stamp && *stamp == loudness.stamp_)
+            return loudness;
+    }
+    return {};
+}
+
+bool SongLoudness::save_all(vector<SongLoudness> const& entries) noexcept {
+    return SQLite::self().transaction([&entries] {
+        return std::ranges::all_of(entries, [] (auto const& loudness) { return loudness.save(); });
+    });
+}
+
+/// Gain to the reference loudness, limited by the true peak (peak x gain <= 1)
+/// and by MAX_GAIN_DB.
+float SongLoudness::gain(double const lufs, double const peak) noexcept {
+    auto gain = pow(10., std::min(REFERENCE_LUFS - lufs, MAX_GAIN_DB) / 20.);
+    if (peak > 0.)
+        gain = std::min(gain, 1. / peak);
+    return float(gain);
+}
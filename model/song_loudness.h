@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../sqlite/row.h"
+#include "song_tags.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+/// Loudness of the song (EBU R128) and of its album, table 'song_loudness'.
+/// Like the tags, the entry is valid as long as the file has the same
+/// mtime and size. From it comes the ReplayGain (2.0) gain for playback:
+/// to the reference loudness, but never so much that the true peak clips.
+class SongLoudness {
+    using i64 = int64_t;
+    inline static std::string const CreateSongLoudnessCmd = R"(
+        CREATE TABLE IF NOT EXISTS song_loudness (
+            path TEXT PRIMARY KEY,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            track_lufs REAL NOT NULL,
+            track_peak REAL NOT NULL,
+            album_lufs REAL NOT NULL,
+            album_peak REAL NOT NULL
+        )
+    )";
+
+    std::string path_{};
+    SongTags::Stamp stamp_{};
+    double track_lufs_{};
+    double track_peak_{};
+    double album_lufs_{};
+    double album_peak_{};
+
+public:
+    static constexpr double REFERENCE_LUFS{-18.};
+    // A near-silent song is not raised to its noise floor.
+    static constexpr double MAX_GAIN_DB{12.};
+
+    explicit SongLoudness(Row&&);
+    SongLoudness(std::string path, SongTags::Stamp const stamp, double const track_lufs, double const track_peak) :
+        path_{std::move(path)},
+        stamp_{stamp},
+        track_lufs_{track_lufs},
+        track_peak_{track_peak}
+    {}
+    void set_album(double const lufs, double const peak) noexcept {
+        album_lufs_ = lufs;
+        album_peak_ = peak;
+    }
+    bool save() const noexcept;
+
+    /// Linear gains for playback.
+    float track_gain() const noexcept { return gain(track_lufs_, track_peak_); }
+    float album_gain() const noexcept { return gain(album_lufs_, album_peak_); }
+
+    static bool create_table() noexcept;
+    /// The entry, if the file hasn't changed since it was measured.
+    static std::optional<SongLoudness> for_path(std::string const& path) noexcept;
+    /// Save all entries (of one album) in one transaction.
+    static bool save_all(std::vector<SongLoudness> const& entries) noexcept;
+
+private:
+    static float gain(double lufs, double peak) noexcept;
+};
@@ -0,0 +1,207 @@
+#include "song_tags.h"
+#include "../sqlite/sqlite.h"
+#include "../library/tag_reader.h"
+#include "../library/content_hash.h"
+#include <algorithm>
+#include <filesystem>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+using namespace std;
+
+SongTags::SongTags(Row&& row) {
+    if (auto const f = row["path"])
+        path_ = f->value().value<std::string>();
+    if (auto const f = row["mtime"])
+        mtime_ = f->value().value<i64>();
+    if (auto const f = row["size"])
+        size_ = f->value().value<i64>();
+    if (auto const f = row["title"]; f && !f->value().is_null())
+        title_ = f->value().value<std::string>();
+    if (auto const f = row["artist"]; f && !f->value().is_null())
+        artist_ = f->value().value<std::string>();
+    if (auto const f = row["album"]; f && !f->value().is_null())
+        album_ = f->value().value<std::string>();
+    if (auto const f = row["track"]; f && !f->value().is_null())
+        track_ = f->value().value<i64>();
+    if (auto const f = row["year"]; f && !f->value().is_null())
+        year_ = f->value().value<i64>();
+    if (auto const f = row["duration"]; f && !f->value().is_null())
+        duration_ = f->value().value<i64>();
+    if (auto const f = row["hash"]; f && !f->value().is_null())
+        hash_ = f->value().value<i64>();
+}
+
+bool SongTags::save() const noexcept {
+    static auto const query{"INSERT OR REPLACE INTO song_tags (path, mtime, size, title, artist, album, track, year, duration, hash) VALUES(?,?,?,?,?,?,?,?,?,?)"s};
+    return SQLite::self().exec(query, path_, mtime_, size_, title_, artist_, album_, track_, year_, duration_, hash_);
+}
+
+bool SongTags::create_table() noexcept {
+    if (!SQLite::self().exec(CreateSongTagsCmd))
+        return false;
+    // The table from before durations (or hashes): the missing columns
+    // are added and the entries dropped, the cache is filled again by the tag scanner.
+    static auto const query{"SELECT COUNT(*) AS count FROM pragma_table_info('song_tags') WHERE name=?"s};
+    auto outdated = false;
+    for (auto const column : {"duration"s, "hash"s})
+        if (auto result = SQLite::self().select(query, column); result && result->size() == 1)
+            if (auto const f = result.value()[0]["count"]; f && f->value().value<i64>() == 0) {
+                if (!SQLite::self().exec("ALTER TABLE song_tags ADD COLUMN " + column + " INTEGER"))
+                    return false;
+                outdated = true;
+            }
+    if (outdated && !SQLite::self().exec("DELETE FROM song_tags"s))
+        return false;
+    return SQLite::self().exec(CreateSongTagsHashIndexCmd);
+}
+
+auto SongTags::for_path(string const& path) noexcept
+-> optional<SongTags> {
+    static auto const query{"SELECT * FROM song_tags WHERE path=?"s};
+    if (auto const result = SQLite::self().select(query, path))
+        if (result->size() == 1)
+            return SongTags(result.value()[0]);
+    return {};
+}
+
+auto SongTags::of(string const& path) noexcept
+-> SongTags {
+    auto const current = stamp(path);
+    if (!current) {
+        SongTags tags{path};
+        tags.fill_from_path();
+        return tags;
+    }
+    if (auto cached = for_path(path); cached && Stamp{cached->mtime_, cached->size_} == *current)
+        return std::move(*cached);
+
+    auto tags = read(path, *current);
+    tags.save();
+    return tags;
+}
+
+auto SongTags::read(string const& path, Stamp const stamp) noexcept
+-> SongTags {
+    SongTags tags{path};
+    tags.mtime_ = stamp.mtime;
+    tags.size_ = stamp.size;
+    if (auto read = TagReader::read(path)) {
+        tags.title_ = std::move(read->title);
+        tags.artist_ = std::move(read->artist);
+        tags.album_ = std::move(read->album);
+        tags.track_ = read->track;
+        tags.year_ = read->year;
+        tags.duration_ = read->duration_ms;
+    }
+    if (auto const hash = ContentHash::of(path, stamp.size))
+        tags.hash_ = i64(*hash);
+    tags.fill_from_path();
+    return tags;
+}
+
+auto SongTags::stamp(string const& path) noexcept
+-> optional<Stamp> {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0)
+        return {};
+    return Stamp{
+        .mtime = static_cast<i64>(st.st_mtim.tv_sec) * 1'000'000'000 + st.st_mtim.tv_nsec,
+        .size = static_cast<i64>(st.st_size)
+    };
+}
+
+auto SongTags::stamps() noexcept
+-> unordered_map<string, Stamp> {
+    unordered_map<string, Stamp> data{};
+    if (auto result = SQLite::self().select("SELECT path, mtime, size FROM song_tags"s)) {
+        data.reserve(result->size());
+        for (auto&& row : result.value()) {
+            auto const path = row["path"];
+            auto const mtime = row["mtime"];
+            auto const size = row["size"];
+            if (path && mtime && size)
+                data.emplace(path->value().value<std::string>(),
+                             Stamp{mtime->value().value<i64>(), size->value().value<i64>()});
+        }
+    }
+    return data;
+}
+
+auto SongTags::path_for_hash(i64 const hash) noexcept
+-> optional<string> {
+    static auto const query{"SELECT path, mtime, size FROM song_tags WHERE hash=?"s};
+    if (auto result = SQLite::self().select(query, hash))
+        for (auto&& row : result.value()) {
+            auto const path = row["path"];
+            auto const mtime = row["mtime"];
+            auto const size = row["size"];
+            if (!path || !mtime || !size)
+                continue;
+            auto candidate = path->value().value<std::string>();
+            if (stamp(candidate) == Stamp{mtime->value().value<i64>(), size->value().value<i64>()})
+                return candidate;
+        }
+    return {};
+}
+
+auto SongTags::durations(vector<string> const& paths) noexcept
+-> unordered_map<string, i64> {
+    unordered_map<string, i64> data{};
+    select_in("SELECT path, duration FROM song_tags WHERE duration > 0 AND path IN (", paths, [&data] (Row&& row) {
+        auto const path = row["path"];
+        auto const duration = row["duration"];
+        if (path && duration && !duration->value().is_null())
+            data.emplace(path->value().value<std::string>(), duration->value().value<i64>());
+    });
+    return data;
+}
+
+auto SongTags::cached(vector<string> const& paths) noexcept
+-> unordered_map<string, SongTags> {
+    unordered_map<string, SongTags> data{};
+    select_in("SELECT * FROM song_tags WHERE path IN (", paths, [&data] (Row&& row) {
+        SongTags tags(std::move(row));
+        auto path = tags.path_;
+        data.emplace(std::move(path), std::move(tags));
+    });
+    return data;
+}
+
+/// Rows of the query for the paths. The paths go as parameters
+/// of 'IN' (the query ends with "IN ("), in chunks under the SQLite variables limit.
+void SongTags::select_in(string const& head, vector<string> const& paths, function<void(Row&&)> const& on_row) noexcept {
+    static constexpr size_t CHUNK_SIZE{500};
+    for (size_t first = 0; first < paths.size(); first += CHUNK_SIZE) {
+        auto const n = std::min(CHUNK_SIZE, paths.size() - first);
+        auto query = head + '?';
+        for (size_t i = 1; i < n; ++i)
+            query += ",?";
+        query += ')';
+        vector<Value> values{};
+        values.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            values.emplace_back(paths[first + i]);
+        if (auto result = SQLite::self().select(Query{std::move(query), std::move(values)}))
+            for (auto&& row : result.value())
+                on_row(std::move(row));
+    }
+}
+
+bool SongTags::save_all(vector<SongTags> const& entries) noexcept {
+    return SQLite::self().transaction([&entries] {
+        return std::ranges::all_of(entries, [] (auto const& tags) { return tags.save(); });
+    });
+}
+
+/// .../performer/album/title.mp3 - the way the collection is organised.
+void SongTags::fill_from_path() noexcept {
+    fs::path const path{path_};
+    if (title_.empty())
+        title_ = path.stem().string();
+    auto const album_dir = path.parent_path();
+    if (album_.empty() && album_dir.has_filename())
+        album_ = album_dir.filename().string();
+    auto const artist_dir = album_dir.parent_path();
+    if (artist_.empty() && artist_dir.has_filename() && artist_dir != artist_dir.root_path())
+        artist_ = artist_dir.filename().string();
+}
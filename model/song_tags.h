@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../sqlite/row.h"
+#include <QString>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+
+/// Tags of the song file cached in the table 'song_tags'.
+/// The entry is valid as long as the file has the same mtime and size,
+/// so a song already seen costs one stat and one select.
+/// What the file has no tags for is taken from its path
+/// (title from the file name, album and artist from the directories).
+/// The duration is taken from the headers, so it is known before the song is played.
+/// The content hash (see ContentHash) finds the song again when it is moved.
+class SongTags {
+    using i64 = int64_t;
+    inline static std::string const CreateSongTagsCmd = R"(
+        CREATE TABLE IF NOT EXISTS song_tags (
+            path TEXT PRIMARY KEY,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            title TEXT,
+            artist TEXT,
+            album TEXT,
+            track INTEGER,
+            year INTEGER,
+            duration INTEGER,
+            hash INTEGER
+        )
+    )";
+    inline static std::string const CreateSongTagsHashIndexCmd = R"(
+        CREATE INDEX IF NOT EXISTS song_tags_hash ON song_tags (hash)
+    )";
+
+    std::string path_{};
+    i64 mtime_{};       // nanoseconds
+    i64 size_{};
+    std::string title_{};
+    std::string artist_{};
+    std::string album_{};
+    i64 track_{};
+    i64 year_{};
+    i64 duration_{};    // milliseconds, 0 if unknown
+    i64 hash_{};        // content hash, 0 if the file couldn't be read
+
+public:
+    /// What the cache entry is validated with.
+    struct Stamp {
+        i64 mtime{};
+        i64 size{};
+        bool operator==(Stamp const&) const = default;
+    };
+
+    explicit SongTags(Row&&);
+    explicit SongTags(std::string path) : path_{std::move(path)} {}
+    bool save() const noexcept;
+    i64 size() const noexcept { return size_; }
+
+    QString title() const noexcept { return QString::fromStdString(title_); }
+    QString artist() const noexcept { return QString::fromStdString(artist_); }
+    QString album() const noexcept { return QString::fromStdString(album_); }
+    int track() const noexcept { return int(track_); }
+    int year() const noexcept { return int(year_); }
+    i64 duration_ms() const noexcept { return duration_; }
+    i64 hash() const noexcept { return hash_; }
+
+    static bool create_table() noexcept;
+    static std::optional<SongTags> for_path(std::string const& path) noexcept;
+
+    /// Tags of the song. From the cache if it is still valid,
+    /// otherwise the file is read (and the cache updated).
+    static SongTags of(std::string const& path) noexcept;
+    /// Tags read from the file (the cache is not touched).
+    static SongTags read(std::string const& path, Stamp stamp) noexcept;
+    /// Current stamp of the file (nothing if the file can't be stat-ed).
+    static std::optional<Stamp> stamp(std::string const& path) noexcept;
+    /// Stamps of all cached entries (path -> stamp).
+    static std::unordered_map<std::string, Stamp> stamps() noexcept;
+    /// Path of an existing song with the content hash (the cache entry must be valid).
+    static std::optional<std::string> path_for_hash(i64 hash) noexcept;
+    /// Durations of the songs already in the cache (path -> ms, only known ones).
+    static std::unordered_map<std::string, i64> durations(std::vector<std::string> const& paths) noexcept;
+    /// Cached entries of the songs (path -> tags), not validated (no file is touched).
+    static std::unordered_map<std::string, SongTags> cached(std::vector<std::string> const& paths) noexcept;
+    /// Save all entries in one transaction.
+    static bool save_all(std::vector<SongTags> const& entries) noexcept;
+
+private:
+    void fill_from_path() noexcept;
+    static void select_in(std::string const& head, std::vector<std::string> const& paths, std::function<void(Row&&)> const& on_row) noexcept;
+};
@@ -0,0 +1,60 @@
+#include "song_tempo.h"
+#include "../sqlite/sqlite.h"
+#include <algorithm>
+using namespace std;
+
+bool SongTempo::create_table() noexcept {
+    return SQLite::self().exec(CreateSongTempoCmd);
+}
+
+bool SongTempo::save(string const& path, SongTags::Stamp const stamp, TempoKey const& tempo) noexcept {
+    static auto const query{"INSERT OR REPLACE INTO song_tempo (path, mtime, size, bpm, key) VALUES(?,?,?,?,?)"s};
+    return SQLite::self().exec(query, path, stamp.mtime, stamp.size, tempo.bpm, tempo.key);
+}
+
+auto SongTempo::of(vector<string> const& paths) noexcept
+-> unordered_map<string, TempoKey> {
+    // Paths go as parameters of 'IN', in chunks under the SQLite variables limit.
+    static constexpr size_t CHUNK_SIZE{500};
+    unordered_map<string, TempoKey> data{};
+    vector<string> stale{};
+    for (size_t first = 0; first < paths.size(); first += CHUNK_SIZE) {
+        auto const n = std::min(CHUNK_SIZE, paths.size() - first);
+        string query{"SELECT path, mtime, size, bpm, key FROM song_tempo WHERE path IN (?"};
+        for (size_t i = 1; i < n; ++i)
+            query += ",?";
+        query += ')';
+        vector<Value> values{};
+        values.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            values.emplace_back(paths[first + i]);
+        if (auto result = SQLite::self().select(Query{std::move(query), std::move(values)}))
+            for (auto&& row : result.value()) {
+                auto const path = row["path"];
+                auto const mtime = row["mtime"];
+                auto const size = row["size"];
+                if (!path || !mtime || !size)
+                    continue;
+                auto file = path->value().value<std::string>();
+                if (SongTags::stamp(file) != SongTags::Stamp{mtime->value().value<int64_t>(), size->value().value<int64_t>()}) {
+                    stale.push_back(std::move(file));
+                    continue;
+                }
+                TempoKey tempo{};
+                if (auto const f = row["bpm"]; f && !f->value().is_null())
+                    tempo.bpm = f->value().value<double>();
+                if (auto const f = row["key"]; f && !f->value().is_null())
+                    tempo.key = int(f->value().value<int64_t>());
+                data.emplace(std::move(file), tempo);
+            }
+    }
+    if (!stale.empty()) {
+        auto const& db = SQLite::self();
+        db.transaction([&] {
+            return std::ranges::all_of(stale, [&db] (auto const& path) {
+                return db.exec("DELETE FROM song_tempo WHERE path=?"s, path);
+            });
+        });
+    }
+    return data;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "song_tags.h"
+#include "../audio/tempo_key.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/// Tempo and key of the songs (table 'song_tempo'), estimated
+/// by the Fingerprinter from the same window as the fingerprint.
+/// Like the tags, the entry is valid as long as the file has the same mtime and size.
+class SongTempo {
+    inline static std::string const CreateSongTempoCmd = R"(
+        CREATE TABLE IF NOT EXISTS song_tempo (
+            path TEXT PRIMARY KEY,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            bpm REAL,
+            key INTEGER
+        )
+    )";
+public:
+    static bool create_table() noexcept;
+    static bool save(std::string const& path, SongTags::Stamp stamp, TempoKey const& tempo) noexcept;
+    /// Tempo and key of the songs which have them (path -> entry).
+    /// Entries of changed (or removed) files are deleted, not returned.
+    static std::unordered_map<std::string, TempoKey> of(std::vector<std::string> const& paths) noexcept;
+};
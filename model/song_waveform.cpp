@@ -0,0 +1,34 @@
+#include "song_waveform.h"
+#include "song_tags.h"
+#include "../sqlite/sqlite.h"
+using namespace std;
+
+bool SongWaveform::create_table() noexcept {
+    return SQLite::self().exec(CreateSongWaveformCmd);
+}
+
+auto SongWaveform::for_path(string const& path) noexcept
+-> optional<Waveform> {
+    static auto const query{"SELECT * FROM song_waveform WHERE path=?"s};
+    auto const stamp = SongTags::stamp(path);
+    if (!stamp)
+        return {};
+    if (auto result = SQLite::self().select(query, path); result && result->size() == 1) {
+        auto row = result.value()[0];
+        auto const mtime = row["mtime"];
+        auto const size = row["size"];
+        auto const data = row["data"];
+        if (mtime && size && data
+            && SongTags::Stamp{mtime->value().value<int64_t>(), size->value().value<int64_t>()} == *stamp)
+            return Waveform::from_blob(data->value().value<vector<u8>>());
+    }
+    return {};
+}
+
+bool SongWaveform::save(string const& path, Waveform const& waveform) noexcept {
+    static auto const query{"INSERT OR REPLACE INTO song_waveform (path, mtime, size, data) VALUES(?,?,?,?)"s};
+    auto const stamp = SongTags::stamp(path);
+    if (!stamp || waveform.empty())
+        return false;
+    return SQLite::self().exec(query, path, stamp->mtime, stamp->size, waveform.to_blob());
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../audio/waveform.h"
+#include <string>
+#include <optional>
+
+/// Waveforms of the songs (for the progress slider), table 'song_waveform'.
+/// Made when the song is decoded whole for the first time; like the tags,
+/// the entry is valid as long as the file has the same mtime and size.
+class SongWaveform {
+    inline static std::string const CreateSongWaveformCmd = R"(
+        CREATE TABLE IF NOT EXISTS song_waveform (
+            path TEXT PRIMARY KEY,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            data BLOB NOT NULL
+        )
+    )";
+public:
+    static bool create_table() noexcept;
+    static std::optional<Waveform> for_path(std::string const& path) noexcept;
+    static bool save(std::string const& path, Waveform const& waveform) noexcept;
+};
@@ -0,0 +1,361 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "playlist_model.h"
+#include "model/song_tempo.h"
+#include "shared/event.hh"
+#include "shared/event_controller.hh"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+PlaylistModel::PlaylistModel(QObject* const parent) : QAbstractTableModel(parent) {
+    EventController::self().append(this, event::PlaylistCached);
+}
+
+PlaylistModel::~PlaylistModel() {
+    EventController::self().remove(this);
+}
+
+int PlaylistModel::rowCount(QModelIndex const& parent) const {
+    return parent.isValid() ? 0 : int(paths_.size());
+}
+
+int PlaylistModel::columnCount(QModelIndex const& parent) const {
+    return parent.isValid() ? 0 : COLUMNS;
+}
+
+QVariant PlaylistModel::data(QModelIndex const& index, int const role) const {
+    if (!index.isValid() || index.row() >= paths_.size())
+        return {};
+
+    auto const& path = paths_[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case TITLE:  return tags(index.row()).title();
+        case ARTIST: return tags(index.row()).artist();
+        case ALBUM:  return tags(index.row()).album();
+        case BPM:
+            if (auto const bpm = tempo_[index.row()].bpm; bpm > 0.)
+                return QString::number(bpm, 'f', 0);
+            break;
+        case KEY:
+            if (auto const key = tempo_[index.row()].key; key != TempoKey::NO_KEY)
+                return QString("%1 (%2)")
+                    .arg(QString::fromStdString(TempoKey::key_name(key)))
+                    .arg(QString::fromStdString(TempoKey::camelot(key)));
+            break;
+        case DURATION:
+            if (auto const ms = tags(index.row()).duration_ms(); ms > 0)
+                return format_duration(ms);
+            break;
+        }
+        break;
+    case Qt::TextAlignmentRole:
+        if (index.column() == DURATION || index.column() == BPM)
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        break;
+    case Qt::ToolTipRole:
+        return path;
+    case PATH:
+        return path;
+    }
+    return {};
+}
+
+QVariant PlaylistModel::headerData(int const section, Qt::Orientation const orientation, int const role) const {
+    if (orientation != Qt::Horizontal)
+        return {};
+    if (role == Qt::ToolTipRole && section == DURATION)
+        return QString("Total time of %1 of %2 songs").arg(counted_.count()).arg(paths_.size());
+    if (role != Qt::DisplayRole)
+        return {};
+    switch (section) {
+    case TITLE:  return QString("Title");
+    case ARTIST: return QString("Performer");
+    case ALBUM:  return QString("Album");
+    case BPM:    return QString("BPM");
+    case KEY:    return QString("Key");
+    case DURATION:
+        // Songs not in the cache yet are not counted.
+        if (total_ms_ > 0)
+            return format_duration(total_ms_) + (!counted_.all() ? "+" : "");
+        return QString("Time");
+    }
+    return {};
+}
+
+void PlaylistModel::reset(QStringList paths) {
+    beginResetModel();
+    paths_ = std::move(paths);
+    rows_.clear();
+    tags_.clear();
+    tags_.resize(paths_.size());
+    counted_.clear();
+    counted_.resize(paths_.size());
+    total_ms_ = 0;
+    tempo_.clear();
+    tempo_.resize(paths_.size());
+    endResetModel();
+    update_cached();
+}
+
+/********************************************************************
+ *                                                                  *
+ *                    u p d a t e _ c a c h e d                     *
+ *                                                                  *
+ *******************************************************************/
+
+/// After a reset, or when the tag scanner finished. Durations, tempo and key
+/// of the cached songs are taken in the background and come back with an event.
+/// The previous request (if it still runs) is stopped, its result would be dropped anyway.
+void PlaylistModel::update_cached() {
+    std::vector<std::string> paths{};
+    paths.reserve(paths_.size());
+    for (auto const& path : paths_)
+        paths.push_back(path.toStdString());
+    cached_worker_ = std::jthread([id = ++cached_id_, paths = std::move(paths)] (std::stop_token const& token) {
+        auto const durations = SongTags::durations(paths);
+        if (token.stop_requested())
+            return;
+        auto const tempo = SongTempo::of(paths);
+        if (token.stop_requested())
+            return;
+        // Songs with anything known, the values go in parallel lists.
+        QStringList found{};
+        QVariantList ms{}, bpm{}, key{};
+        for (auto const& path : paths) {
+            auto const d = durations.find(path);
+            auto const t = tempo.find(path);
+            if (d == durations.end() && t == tempo.end())
+                continue;
+            found << QString::fromStdString(path);
+            ms << qint64(d != durations.end() ? d->second : 0);
+            bpm << (t != tempo.end() ? t->second.bpm : 0.);
+            key << (t != tempo.end() ? t->second.key : TempoKey::NO_KEY);
+        }
+        EventController::self().send(event::PlaylistCached, id, found, ms, bpm, key);
+    });
+}
+
+void PlaylistModel::customEvent(QEvent* const event) {
+    auto const e = dynamic_cast<Event*>(event);
+    switch (int(e->type())) {
+
+    // Durations (songs already counted stay as they are), tempo and key of the cached songs.
+    case event::PlaylistCached:
+        if (auto const data = e->data(); data.size() == 5 && data[0].toUInt() == cached_id_) {
+            auto const paths = data[1].toStringList();
+            auto const ms = data[2].toList();
+            auto const bpm = data[3].toList();
+            auto const key = data[4].toList();
+            if (ms.size() != paths.size() || bpm.size() != paths.size() || key.size() != paths.size())
+                break;
+            for (qsizetype i = 0; i < paths.size(); ++i)
+                if (auto const row = row_for(paths[i]); row != -1) {
+                    count(row, ms[i].toLongLong());
+                    tempo_[row] = {.bpm = bpm[i].toDouble(), .key = key[i].toInt()};
+                }
+            if (!paths_.isEmpty())
+                emit dataChanged(index(0, BPM), index(int(paths_.size()) - 1, KEY));
+        }
+        break;
+    }
+}
+
+/********************************************************************
+ *                                                                  *
+ *                    u p d a t e _ t e m p o                       *
+ *                                                                  *
+ *******************************************************************/
+
+/// The fingerprinter estimated tempo and key of the song.
+void PlaylistModel::update_tempo(QString const& path) {
+    auto const row = row_for(path);
+    if (row == -1)
+        return;
+    auto const tempo = SongTempo::of({path.toStdString()});
+    if (auto const it = tempo.begin(); it != tempo.end())
+        tempo_[row] = it->second;
+    else
+        tempo_[row] = {};
+    emit dataChanged(index(row, BPM), index(row, KEY));
+}
+
+/********************************************************************
+ *                                                                  *
+ *                            s o r t                               *
+ *                                                                  *
+ *******************************************************************/
+
+/// Called by the view (click on the header). Songs without the value
+/// (tags not in the cache, tempo or key not known yet) are always at the end.
+/// Tags of the songs not shown yet are taken from the cache at once, no file
+/// is read here. Keys are sorted by their position on the Camelot wheel.
+void PlaylistModel::sort(int const column, Qt::SortOrder const order) {
+    if (paths_.size() < 2 || column < 0 || column >= COLUMNS)
+        return;
+
+    std::unordered_map<std::string, SongTags> cached{};
+    if (column <= ALBUM || column == DURATION) {
+        std::vector<std::string> paths{};
+        for (auto i = 0; i < paths_.size(); ++i)
+            if (!tags_[i])
+                paths.push_back(paths_[i].toStdString());
+        cached = SongTags::cached(paths);
+    }
+    // Tags of the row: taken already, or from the cache.
+    auto const tags_of = [this, &cached] (int const row) -> SongTags const* {
+        if (auto const& tags = tags_[row])
+            return &*tags;
+        if (auto const it = cached.find(paths_[row].toStdString()); it != cached.end()) {
+            count(row, it->second.duration_ms());
+            return &it->second;
+        }
+        return nullptr;
+    };
+
+    // Sort key of the row: nothing if the value is unknown.
+    auto const value = [this, column, &tags_of] (int const row) -> std::optional<QVariant> {
+        switch (column) {
+        case TITLE:
+            if (auto const tags = tags_of(row))
+                return tags->title();
+            break;
+        case ARTIST:
+            if (auto const tags = tags_of(row))
+                return tags->artist();
+            break;
+        case ALBUM:
+            if (auto const tags = tags_of(row))
+                return tags->album();
+            break;
+        case BPM:
+            if (tempo_[row].bpm > 0.)
+                return tempo_[row].bpm;
+            break;
+        case KEY:
+            if (auto const key = tempo_[row].key; key != TempoKey::NO_KEY)
+                return 2 * TempoKey::camelot_number(key) + (key < 12);
+            break;
+        case DURATION:
+            if (auto const tags = tags_of(row); tags && tags->duration_ms() > 0)
+                return qlonglong(tags->duration_ms());
+            break;
+        }
+        return {};
+    };
+    std::vector<std::optional<QVariant>> values{};
+    values.reserve(paths_.size());
+    for (auto i = 0; i < paths_.size(); ++i)
+        values.push_back(value(i));
+
+    std::vector<int> rows(paths_.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::ranges::stable_sort(rows, [&values, column, order] (int const a, int const b) {
+        auto const& va = values[a];
+        auto const& vb = values[b];
+        if (!va || !vb)
+            return va && !vb;
+        auto const cmp = (column <= ALBUM)
+            ? va->toString().localeAwareCompare(vb->toString())
+            : (va->toDouble() < vb->toDouble() ? -1 : va->toDouble() > vb->toDouble() ? 1 : 0);
+        return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+    });
+
+    emit layoutAboutToBeChanged({}, VerticalSortHint);
+    std::vector<int> new_row(rows.size());
+    QStringList paths{};
+    std::vector<std::optional<SongTags>> tags{};
+    std::vector<TempoKey> tempo{};
+    BitVector counted(rows.size());
+    paths.reserve(paths_.size());
+    tags.reserve(rows.size());
+    tempo.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        new_row[rows[i]] = int(i);
+        paths << std::move(paths_[rows[i]]);
+        tags.push_back(std::move(tags_[rows[i]]));
+        tempo.push_back(tempo_[rows[i]]);
+        counted.set(i, counted_.test(size_t(rows[i])));
+    }
+    paths_ = std::move(paths);
+    tags_ = std::move(tags);
+    tempo_ = std::move(tempo);
+    counted_ = std::move(counted);
+    rows_.clear();
+
+    auto const before = persistentIndexList();
+    QModelIndexList after{};
+    after.reserve(before.size());
+    for (auto const& index : before)
+        after << this->index(new_row[index.row()], index.column());
+    changePersistentIndexList(before, after);
+    emit layoutChanged({}, VerticalSortHint);
+}
+
+SongTags const& PlaylistModel::tags(int const row) const noexcept {
+    auto& tags = tags_[row];
+    if (!tags) {
+        tags = SongTags::of(paths_[row].toStdString());
+        count(row, tags->duration_ms());
+    }
+    return *tags;
+}
+
+/// Adds the duration of the song to the total (once). Rows are painted
+/// in batches, the header is updated once per batch.
+void PlaylistModel::count(int const row, qint64 const duration_ms) const noexcept {
+    if (duration_ms <= 0 || !counted_.set(size_t(row), true))
+        return;
+    total_ms_ += duration_ms;
+    if (!std::exchange(header_pending_, true))
+        QMetaObject::invokeMethod(const_cast<PlaylistModel*>(this), [self = const_cast<PlaylistModel*>(this)] {
+            self->header_pending_ = false;
+            emit self->headerDataChanged(Qt::Horizontal, DURATION, DURATION);
+        }, Qt::QueuedConnection);
+}
+
+int PlaylistModel::row_for(QString const& path) const noexcept {
+    if (rows_.empty() && !paths_.isEmpty()) {
+        rows_.reserve(paths_.size());
+        for (auto i = 0; i < paths_.size(); ++i)
+            rows_.emplace(paths_[i], i);
+    }
+    if (auto const it = rows_.find(path); it != rows_.end())
+        return it->second;
+    return -1;
+}
+
+/// m:ss, or h:mm:ss for an hour and more.
+QString PlaylistModel::format_duration(qint64 const ms) noexcept {
+    auto const sec = ms / 1000;
+    if (sec >= 3600)
+        return QString("%1:%2:%3").arg(sec / 3600).arg(sec / 60 % 60, 2, 10, QChar('0')).arg(sec % 60, 2, 10, QChar('0'));
+    return QString("%1:%2").arg(sec / 60).arg(sec % 60, 2, 10, QChar('0'));
+}
@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "model/song_tags.h"
+#include "audio/tempo_key.h"
+#include "shared/bit_vector.hh"
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <unordered_map>
+#include <optional>
+#include <vector>
+#include <thread>
+
+/*------- PlaylistModel ::QAbstractTableModel:
+-------------------------------------------------------------------*/
+/// Songs of the playlist (or of the current selection) for the PlaylistTable.
+/// We keep only paths, tags of the song are taken (from the cache)
+/// when the view asks for them (only visible rows).
+/// The total time of the songs is shown in the header of the time column.
+/// Durations of the cached songs are taken in the background (one query
+/// per chunk), songs read later add theirs as they come; every song
+/// is counted once. Tempo and key are small, they come for all songs
+/// with the durations (and the rows can be sorted by them).
+class PlaylistModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum {PATH = Qt::UserRole + 1};
+    enum Column {TITLE, ARTIST, ALBUM, BPM, KEY, DURATION, COLUMNS};
+private:
+    QStringList paths_{};
+    mutable std::vector<std::optional<SongTags>> tags_{};
+    std::vector<TempoKey> tempo_{};
+    // path -> row, built when it is needed for the first time.
+    mutable std::unordered_map<QString, int> rows_{};
+    // Songs counted in the total and their duration.
+    mutable BitVector counted_{};
+    mutable qint64 total_ms_{};
+    mutable bool header_pending_{};     // headerDataChanged is already queued
+    uint cached_id_{};                  // the last request for the cached data
+    std::jthread cached_worker_{};
+
+public:
+    explicit PlaylistModel(QObject* = nullptr);
+    ~PlaylistModel() override;
+
+    int rowCount(QModelIndex const& parent = {}) const override;
+    int columnCount(QModelIndex const& parent = {}) const override;
+    QVariant data(QModelIndex const& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    void sort(int column, Qt::SortOrder order) override;
+
+    void reset(QStringList paths);
+    void update_cached();
+    void customEvent(QEvent*) override;
+    void update_tempo(QString const& path);
+    int row_for(QString const& path) const noexcept;
+    QString const& path(int const row) const noexcept {
+        return paths_[row];
+    }
+    TempoKey const& tempo(int const row) const noexcept {
+        return tempo_[row];
+    }
+    static QString format_duration(qint64 ms) noexcept;
+private:
+    SongTags const& tags(int row) const noexcept;
+    void count(int row, qint64 duration_ms) const noexcept;
+};
@@ -28,34 +28,52 @@
 #include "model/selection.h"
 #include "model/song.h"
 #include "playlist_table.h"
+#include "playlist_model.h"
+#include "audio/tempo_key.h"
 #include "shared/event.hh"
 #include "shared/event_controller.hh"
 #include <QDir>
 #include <QMenu>
 #include <QEvent>
 #include <QAction>
-#include <QFileInfo>
 #include <QShowEvent>
 #include <QFocusEvent>
 #include <QMouseEvent>
 #include <QHeaderView>
-#include <QTableWidgetItem>
 #include <QContextMenuEvent>
 #include <iostream>
+#include <cmath>
 // #include <format>
 using namespace std;
 
-PlaylistTable::PlaylistTable(QWidget* const parent) : QTableWidget(parent) {
-    setRowCount(0);
-    setColumnCount(1);
+PlaylistTable::PlaylistTable(QWidget* const parent) :
+    QTableView(parent),
+    model_{new PlaylistModel(this)}
+{
+    setModel(model_);
     setEditTriggers(NoEditTriggers);
     setSelectionBehavior(SelectRows);
-    setHorizontalHeaderItem(0, new QTableWidgetItem("Title"));
     horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    // The playlist order until the user clicks a header.
+    horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    setSortingEnabled(true);
+    // Sorting moves rows, the hidden ones have to follow.
+    connect(model_, &PlaylistModel::layoutChanged, this, [this] {
+        apply_filter();
+    });
+    // Tempo or key of some songs got known, they may pass the filter now.
+    connect(model_, &PlaylistModel::dataChanged, this, [this] (QModelIndex const& top_left, QModelIndex const& bottom_right) {
+        if (top_left.column() <= PlaylistModel::KEY && bottom_right.column() >= PlaylistModel::BPM
+                && (filter_.bpm > 0. || filter_.key != TempoKey::NO_KEY))
+            apply_filter();
+    });
+    // All rows have the same height, so the view doesn't have to
+    // ask for every row to compute its geometry.
+    verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
-    connect(this, &QTableWidget::cellDoubleClicked, [&] (auto const row, auto const col){
-        if (auto const selected_item = item(row, 0)) {
-            auto const path = selected_item->data(PATH).toString();
+    connect(this, &QTableView::doubleClicked, [&] (QModelIndex const& index) {
+        if (index.isValid()) {
+            auto const path = model_->path(index.row());
             EventController::self().send(event::SongShot, path);
         }
     });
@@ -64,8 +82,11 @@ PlaylistTable::PlaylistTable(QWidget* const parent) : QTableWidget(parent) {
         .append(this,
                 event::ShowCurrentSelectedSongs,
                 event::ShowPlaylistSongs,
+                event::SongsRelinked,
                 event::SelectionChanged,
-                event::SongPlayed);
+                event::SongPlayed,
+                event::TagScanFinished,
+                event::TempoFound);
 }
 
 PlaylistTable::~PlaylistTable() {
@@ -80,8 +101,8 @@ PlaylistTable::~PlaylistTable() {
 
 void PlaylistTable::focusOutEvent(QFocusEvent* e) {
     // cout << "PlaylistTable::focusOutEvent\n" << flush;
-    if (auto const item = currentItem())
-        saved_[current_playlist_id_] = item->data(PATH).toString();
+    if (auto const index = currentIndex(); index.isValid())
+        saved_[current_playlist_id_] = model_->path(index.row());
 }
 
 /********************************************************************
@@ -125,7 +146,7 @@ void PlaylistTable::hideEvent(QHideEvent* event) {
 void PlaylistTable::mousePressEvent(QMouseEvent* const event) {
     if (event->button() == Qt::RightButton)
         return;
-    QTableWidget::mousePressEvent(event);
+    QTableView::mousePressEvent(event);
 }
 
 /********************************************************************
@@ -151,15 +172,94 @@ void PlaylistTable::customEvent(QEvent* const event) {
         }
         break;
 
+    // Files of songs were moved, the playlist may show old paths.
+    case event::SongsRelinked:
+        if (current_playlist_id_)
+            content_for_playlist(uint(current_playlist_id_));
+        break;
+
     // Currently playing song.
     case event::SongPlayed:
          if (auto const data = e->data(); !data.empty())
-            if (auto const it = item_for(data[0].toString()))
-                select(it);
+            if (auto const row = row_for(data[0].toString()); row != -1)
+                select(row);
+        break;
+
+    // Tags of more songs are in the cache, the total time may change.
+    case event::TagScanFinished:
+        model_->update_cached();
+        break;
+
+    // Tempo and key of the song are known.
+    case event::TempoFound:
+        if (auto const data = e->data(); !data.empty())
+            model_->update_tempo(data[0].toString());
         break;
     }
 }
 
+/********************************************************************
+ *                                                                  *
+ *                    c o n t e x t M e n u E v e n t               *
+ *                                                                  *
+ *******************************************************************/
+
+/// Filters by the song under the cursor (if its tempo/key is known).
+void PlaylistTable::contextMenuEvent(QContextMenuEvent* const event) {
+    auto const index = indexAt(event->pos());
+    auto const tempo = index.isValid() ? model_->tempo(index.row()) : TempoKey{};
+
+    auto const menu = new QMenu(this);
+    auto const tempo_action = menu->addAction(tempo.bpm > 0.
+        ? QString("Similar tempo (%1 BPM)").arg(tempo.bpm, 0, 'f', 0)
+        : QString("Similar tempo"));
+    tempo_action->setEnabled(tempo.bpm > 0.);
+    auto const key_action = menu->addAction(tempo.key != TempoKey::NO_KEY
+        ? QString("Compatible keys (%1)").arg(QString::fromStdString(TempoKey::camelot(tempo.key)))
+        : QString("Compatible keys"));
+    key_action->setEnabled(tempo.key != TempoKey::NO_KEY);
+    menu->addSeparator();
+    auto const all_action = menu->addAction("Show all songs");
+    all_action->setEnabled(filter_.bpm > 0. || filter_.key != TempoKey::NO_KEY);
+
+    connect(tempo_action, &QAction::triggered, this, [this, tempo] (auto _) {
+        set_filter({.bpm = tempo.bpm, .key = filter_.key});
+    });
+    connect(key_action, &QAction::triggered, this, [this, tempo] (auto _) {
+        set_filter({.bpm = filter_.bpm, .key = tempo.key});
+    });
+    connect(all_action, &QAction::triggered, this, [this] (auto _) {
+        set_filter({});
+    });
+
+    menu->exec(event->globalPos());
+    delete menu;
+}
+
+/********************************************************************
+ *                                                                  *
+ *                          f i l t e r                             *
+ *                                                                  *
+ *******************************************************************/
+
+void PlaylistTable::set_filter(Filter const filter) noexcept {
+    filter_ = filter;
+    apply_filter();
+}
+
+/// Songs with unknown tempo/key don't pass a filter which needs them.
+void PlaylistTable::apply_filter() noexcept {
+    for (auto row = 0; row < model_->rowCount(); ++row) {
+        auto const& tempo = model_->tempo(row);
+        auto visible = true;
+        if (filter_.bpm > 0.)
+            visible = std::abs(tempo.bpm - filter_.bpm) <= filter_.bpm * TEMPO_RANGE;
+        if (filter_.key != TempoKey::NO_KEY)
+            visible = visible && TempoKey::compatible(filter_.key, tempo.key);
+        setRowHidden(row, !visible);
+    }
+}
+
 /********************************************************************
  *                                                                  *
  *           c o n t e n t _ f o r _ s e l e c t i o n s            *
@@ -167,17 +267,10 @@ void PlaylistTable::customEvent(QEvent* const event) {
  *******************************************************************/
 
 void PlaylistTable::content_for_selections() noexcept {
-    clear_content();
-
-    if (!Selection::self().empty()) {
-        int row{};
-        setRowCount(Selection::self().size());
-        std::ranges::for_each(Selection::self(), [this, &row] (auto const& path) {
-            QFileInfo const fi{ QString::fromStdString(path)};
-            auto const item = new QTableWidgetItem(fi.fileName());
-            item->setData(PATH, fi.filePath());
-            setItem(row++, 0, item);
-        });
+    horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    filter_ = {};
+    model_->reset(Selection::self().to_list());
+    if (model_->rowCount()) {
         current_playlist_id_ = 0;
         update_selected();
     }
@@ -190,17 +283,10 @@ void PlaylistTable::content_for_selections() noexcept {
  *******************************************************************/
 
 void PlaylistTable::content_for_playlist(uint playlist_id) noexcept {
-    clear_content();
-
-    if (auto songs = Song::for_pid(playlist_id); !songs.empty()) {
-        int row{};
-        setRowCount(songs.size());
-        std::ranges::for_each(songs, [this, &row] (auto&& song){
-            QFileInfo const fi{song.qpath()};
-            auto const item = new QTableWidgetItem(fi.fileName());
-            item->setData(PATH, fi.filePath());
-            setItem(row++, 0, item);
-        });
+    horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    filter_ = {};
+    model_->reset(Song::qpaths_for(playlist_id));
+    if (model_->rowCount()) {
         current_playlist_id_ = playlist_id;
         update_selected();
     }
@@ -214,11 +300,11 @@ void PlaylistTable::content_for_playlist(uint playlist_id) noexcept {
 
 void PlaylistTable::update_selected() noexcept {
     if (auto const it = saved_.find(current_playlist_id_); it != saved_.end()) {
-        select(item_for(std::move(it->second)));
+        select(row_for(it->second));
         saved_.erase(it);
         return;
     }
-    if (rowCount())
+    if (model_->rowCount())
         selectRow(0);
 }
 
@@ -228,10 +314,11 @@ void PlaylistTable::update_selected() noexcept {
  *                                                                  *
  *******************************************************************/
 
-void PlaylistTable::select(QTableWidgetItem* const item) {
-    if (item) {
-        scrollToItem(item);
-        setCurrentItem(item);
+void PlaylistTable::select(int const row) {
+    if (row != -1) {
+        auto const index = model_->index(row, 0);
+        scrollTo(index);
+        setCurrentIndex(index);
         setFocus();
         return;
     }
@@ -241,13 +328,10 @@ void PlaylistTable::select(QTableWidgetItem* const item) {
 
 /********************************************************************
  *                                                                  *
- *                        i t e m _ f o r                           *
+ *                         r o w _ f o r                            *
  *                                                                  *
  *******************************************************************/
 
-QTableWidgetItem* PlaylistTable::item_for(QString&& path) const noexcept {
-    for (auto i = 0; i < rowCount(); ++i)
-        if (auto const it = item(i, 0); (it->data(PATH) == path))
-            return it;
-    return {};
+int PlaylistTable::row_for(QString const& path) const noexcept {
+    return model_->row_for(path);
 }
@@ -26,7 +26,7 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
-#include <QTableWidget>
+#include <QTableView>
 #include <optional>
 #include <unordered_map>
 
@@ -36,15 +36,26 @@ class QEvent;
 class QHideEvent;
 class QShowEvent;
 class QMouseEvent;
-class QTableWidgetItem;
+class PlaylistModel;
 class QContextMenuEvent;
 
 
-/*------- PlaylistTable ::QTableWidget:
+/*------- PlaylistTable ::QTableView:
 -------------------------------------------------------------------*/
-class PlaylistTable : public QTableWidget {
+/// Songs of the playlist. Rows can be sorted (click on the header)
+/// and filtered (context menu) by tempo and key of a song, the way
+/// a DJ looks for the next track to mix in.
+class PlaylistTable : public QTableView {
     Q_OBJECT
-    enum {PATH = Qt::UserRole + 1, DIR};
+    // Tempo within this part of the song's tempo matches (the usual pitch range).
+    static constexpr double TEMPO_RANGE{0.06};
+    /// Rows which are shown (0/NO_KEY: anything).
+    struct Filter {
+        double bpm{};
+        int key{-1};
+    };
+    PlaylistModel* const model_;
+    Filter filter_{};
     QString dir_{};
     int current_playlist_id_{};
     std::unordered_map<uint, QString> saved_{};    // we save path
@@ -55,21 +66,17 @@ private:
     void showEvent(QShowEvent*) override;
     void hideEvent(QHideEvent*) override;
     void mousePressEvent(QMouseEvent*) override;
-    // void contextMenuEvent(QContextMenuEvent*) override;
+    void contextMenuEvent(QContextMenuEvent*) override;
     void customEvent(QEvent*) override;
 
-    void clear_content() noexcept {
-        // Remove content (and only content, no settings)
-        clearContents();
-        setRowCount(0);
-    }
-
     void content_for_selections() noexcept;
     void content_for_playlist(uint playlist_id) noexcept;
     void update_selected() noexcept;
-    QTableWidgetItem* item_for(QString&& path) const noexcept;
+    int row_for(QString const& path) const noexcept;
+    void set_filter(Filter filter) noexcept;
+    void apply_filter() noexcept;
 
     void focusInEvent(QFocusEvent*) override;
     void focusOutEvent(QFocusEvent*) override;
-    void select(QTableWidgetItem*);
+    void select(int row);
 };
@@ -42,7 +42,6 @@
 #include <QHeaderView>
 #include <QMouseEvent>
 #include <QTreeWidgetItem>
-#include <QTreeWidgetItemIterator>
 using namespace std;
 
 PlaylistTree::PlaylistTree(QWidget* const parent) :
@@ -164,6 +163,7 @@ void PlaylistTree::customEvent(QEvent* const event) {
 
 void PlaylistTree::update_content() {
     clear();
+    items_.clear();
 
     current_selections_ = new QTreeWidgetItem(this);
     current_selections_->setText(0, "Current selections");
@@ -199,6 +199,7 @@ update_playlists()
         item->setText(0, playlist.qname());
         item->setData(0, PID, pid);
         item->setData(0, ID, playlist.qid());
+        items_.emplace(playlist.qname(), item);
     });
 
 }
@@ -267,13 +268,8 @@ auto PlaylistTree::
 item_for(QString&& path) const
 -> QTreeWidgetItem*
 {
-    QTreeWidgetItemIterator it(playlists_);
-    while (*it) {
-        QTreeWidgetItem* const item = *it;
-        if (item->text(0) == path)
-            return item;
-        ++it;
-    }
+    if (auto const it = items_.find(path); it != items_.end())
+        return it->second;
     return {};
 }
 
@@ -28,6 +28,7 @@
 -------------------------------------------------------------------*/
 #include <QTreeWidget>
 #include <unordered_set>
+#include <unordered_map>
 
 /*------- forward declarations:
 -------------------------------------------------------------------*/
@@ -49,6 +50,8 @@ class PlaylistTree : public QTreeWidget {
     QTimer* const timer_;
     std::unordered_set<QString> selections_{};
     QTreeWidgetItem* saved_item_{};
+    // Index of playlist items (playlist name -> item).
+    std::unordered_map<QString, QTreeWidgetItem*> items_{};
 
 public:
     PlaylistTree(QWidget* = nullptr);
@@ -26,17 +26,17 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "progress.h"
+#include "waveform_slider.h"
 #include "shared/event_controller.hh"
 #include <format>
 #include <QLabel>
-#include <QSlider>
 #include <QHBoxLayout>
 
 using namespace std;;
 
 Progress::Progress(QWidget *parent)
     : QWidget{parent}
-    , slider_{new QSlider(Qt::Horizontal)}
+    , slider_{new WaveformSlider}
     , passed_{new QLabel}
     , left_{new QLabel}
 {
@@ -56,7 +56,7 @@ Progress::Progress(QWidget *parent)
     main->addWidget(left_);
     setLayout(main);
 
-    EventController::self().append(this, event::SongRange, event::SongProgress);
+    EventController::self().append(this, event::SongRange, event::SongProgress, event::SongWaveform);
 }
 
 Progress::~Progress() {
@@ -79,6 +79,13 @@ void Progress::customEvent(QEvent* const event) {
             slider_->setSingleStep(1);
         }
         break;
+    // Blob of the song's waveform (empty if it isn't known yet).
+    case event::SongWaveform:
+        if (auto const data = e->data(); data.size() == 1) {
+            auto const blob = data[0].toByteArray();
+            slider_->set_waveform(Waveform::from_blob({reinterpret_cast<uint8_t const*>(blob.constData()), size_t(blob.size())}));
+        }
+        break;
     case event::SongProgress:
         if (auto const data = e->data(); data.size() == 1) {
             auto const position = data[0].toULongLong();
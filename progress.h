@@ -31,11 +31,11 @@
 /*------- forward declarations:
 -------------------------------------------------------------------*/
 class QLabel;
-class QSlider;
+class WaveformSlider;
 
 class Progress : public QWidget {
     Q_OBJECT
-    QSlider* const slider_;
+    WaveformSlider* const slider_;
     QLabel* const passed_;
     QLabel* const left_;
 public:
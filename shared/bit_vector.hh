@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <bit>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*------- BitVector:
+-------------------------------------------------------------------*/
+/// Packed vector of bits with a running count of set bits.
+/// Operations on all bits (fill, flip) work on whole 64-bit words.
+/// Bits beyond size() are always zero.
+class BitVector {
+    static constexpr size_t BITS{64};
+    std::vector<uint64_t> words_{};
+    size_t size_{};
+    size_t count_{};
+public:
+    BitVector() = default;
+    explicit BitVector(size_t const n, bool const value = false) {
+        resize(n);
+        fill(value);
+    }
+
+    size_t size() const noexcept { return size_; }
+    size_t count() const noexcept { return count_; }
+    bool all() const noexcept { return count_ == size_; }
+    bool none() const noexcept { return count_ == 0; }
+
+    void clear() noexcept {
+        words_.clear();
+        size_ = count_ = 0;
+    }
+
+    /// Change the size, new bits are zero.
+    void resize(size_t const n) {
+        if (n < size_) {
+            for (auto i = n; i < size_; ++i)
+                set(i, false);
+        }
+        words_.resize((n + BITS - 1) / BITS, 0);
+        size_ = n;
+    }
+
+    bool test(size_t const pos) const noexcept {
+        return (words_[pos / BITS] >> (pos % BITS)) & 1;
+    }
+
+    /// Set the bit, returns true if the bit has changed.
+    bool set(size_t const pos, bool const value) noexcept {
+        auto& word = words_[pos / BITS];
+        auto const mask = uint64_t{1} << (pos % BITS);
+        if (bool(word & mask) == value)
+            return false;
+        if (value) {
+            word |= mask;
+            ++count_;
+        } else {
+            word &= ~mask;
+            --count_;
+        }
+        return true;
+    }
+
+    void fill(bool const value) noexcept {
+        std::fill(words_.begin(), words_.end(), value ? ~uint64_t{0} : uint64_t{0});
+        trim();
+        count_ = value ? size_ : 0;
+    }
+
+    void flip() noexcept {
+        for (auto& word : words_)
+            word = ~word;
+        trim();
+        count_ = size_ - count_;
+    }
+
+    /// Insert the bit at the position (bits from the position go one up).
+    void insert(size_t const pos, bool const value) {
+        ++size_;
+        words_.resize((size_ + BITS - 1) / BITS, 0);
+
+        auto const wpos = pos / BITS;
+        for (auto w = words_.size() - 1; w > wpos; --w)
+            words_[w] = (words_[w] << 1) | (words_[w - 1] >> (BITS - 1));
+
+        auto const low = low_mask(pos % BITS);
+        auto& word = words_[wpos];
+        word = (word & low) | ((word & ~low) << 1);
+        if (value) {
+            word |= uint64_t{1} << (pos % BITS);
+            ++count_;
+        }
+    }
+
+    /// Remove the bit at the position (bits above the position go one down).
+    void erase(size_t const pos) {
+        if (test(pos))
+            --count_;
+
+        auto const wpos = pos / BITS;
+        auto const low = low_mask(pos % BITS);
+        auto& word = words_[wpos];
+        word = (word & low) | ((word >> 1) & ~low);
+        for (auto w = wpos; w < words_.size(); ++w) {
+            if (w > wpos)
+                words_[w] >>= 1;
+            if (w + 1 < words_.size())
+                words_[w] |= (words_[w + 1] & 1) << (BITS - 1);
+        }
+
+        --size_;
+        words_.resize((size_ + BITS - 1) / BITS);
+    }
+
+    /// Call fn(pos) for every bit which has the given value.
+    template<typename F>
+    void for_each(bool const value, F&& fn) const {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            auto word = value ? words_[w] : ~words_[w];
+            if (w == words_.size() - 1 && size_ % BITS)
+                word &= low_mask(size_ % BITS);
+            while (word) {
+                fn(w * BITS + std::countr_zero(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    static constexpr uint64_t low_mask(size_t const n) noexcept {
+        return n ? (~uint64_t{0} >> (BITS - n)) : 0;
+    }
+    /// Clear bits beyond size().
+    void trim() noexcept {
+        if (!words_.empty() && size_ % BITS)
+            words_.back() &= low_mask(size_ % BITS);
+    }
+};
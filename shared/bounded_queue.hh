@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <optional>
+#include <condition_variable>
+
+/*------- BoundedQueue:
+-------------------------------------------------------------------*/
+/// Multi-producer, multi-consumer queue with limited capacity.
+/// A producer waits while the queue is full, so a fast stage can't
+/// run away from a slow one (back pressure).
+/// close() - no more items will come, consumers take what is left;
+/// abort() - the work is cancelled, everybody returns at once.
+template<typename T>
+class BoundedQueue {
+    std::mutex mutex_{};
+    std::condition_variable not_empty_{};
+    std::condition_variable not_full_{};
+    std::deque<T> items_{};
+    size_t const capacity_;
+    bool closed_{};
+    bool aborted_{};
+public:
+    explicit BoundedQueue(size_t const capacity) : capacity_{std::max<size_t>(1, capacity)} {}
+    BoundedQueue(BoundedQueue const&) = delete;
+    BoundedQueue& operator=(BoundedQueue const&) = delete;
+
+    /// Add the item (waits while the queue is full).
+    /// Returns false if the queue was closed or aborted.
+    bool push(T item) {
+        std::unique_lock lock{mutex_};
+        not_full_.wait(lock, [this] { return items_.size() < capacity_ || closed_ || aborted_; });
+        if (closed_ || aborted_)
+            return false;
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /// Take the item (waits while the queue is empty).
+    /// Returns nothing when the queue is closed and empty, or aborted.
+    std::optional<T> pop() {
+        std::unique_lock lock{mutex_};
+        not_empty_.wait(lock, [this] { return !items_.empty() || closed_ || aborted_; });
+        if (aborted_ || items_.empty())
+            return {};
+        auto item = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return item;
+    }
+
+    /// Take up to 'max' items at once, waiting for them no longer than 'timeout'.
+    /// Returns false when there is nothing more to take (closed and empty, or aborted).
+    /// True with nothing added means the time has passed.
+    template<typename Rep, typename Period>
+    bool pop_many(std::vector<T>& out, size_t const max, std::chrono::duration<Rep, Period> const timeout) {
+        std::unique_lock lock{mutex_};
+        not_empty_.wait_for(lock, timeout, [this] { return !items_.empty() || closed_ || aborted_; });
+        if (aborted_ || (closed_ && items_.empty()))
+            return false;
+        auto const n = std::min(max, items_.size());
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(std::move(items_.front()));
+            items_.pop_front();
+        }
+        lock.unlock();
+        not_full_.notify_all();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard lock{mutex_};
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    void abort() {
+        {
+            std::lock_guard lock{mutex_};
+            aborted_ = true;
+            items_.clear();
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+};
@@ -61,6 +61,7 @@ namespace event {
         SongRange,
         SongProgress,
         SongReprogress,
+        SongWaveform,
         NewPlaylistAdded,
         ShowCurrentSelectedSongs,
         ShowPlaylistSongs,
@@ -73,5 +74,13 @@ namespace event {
         PartlySongsSelected,    // table -> tree
         AllSongsSelected,       // table -> tree
         SelectionChanged,       // selections -> ListTree
+        DirsChanged,            // watcher -> tree
+        FilesChanged,           // watcher -> table
+        TagScanProgress,        // tag scanner -> window
+        TagScanFinished,        // tag scanner -> window
+        DuplicatesFound,        // fingerprinter -> table
+        SongsRelinked,          // tree -> playlist table
+        TempoFound,             // fingerprinter -> playlist table
+        PlaylistCached,         // playlist model's thread -> playlist model
     };
 }
@@ -30,6 +30,7 @@
 #include "query.h"
 #include "stmt.h"
 #include <array>
+#include <mutex>
 #include <functional>
 #include <sqlite3.h>
 
@@ -39,6 +40,9 @@ class SQLite {
         0x6f, 0x72, 0x6d, 0x61, 0x74, 0x20, 0x33, 0x00
     };
     sqlite3 *db_ = nullptr;
+    // The connection is shared by the GUI and background writers (tag scanner).
+    // The lock keeps 'insert' and its rowid together and a transaction in one piece.
+    mutable std::recursive_mutex mutex_{};
 public:
     static constexpr i64 INVALID_ROWID = -1;
     static inline Str IN_MEMORY = ":memory:";
@@ -64,6 +68,7 @@ public:
 
     //------- EXEC ----------
     [[nodiscard]] bool exec(Query const& query) const {
+       std::lock_guard lock{mutex_};
        return Stmt(db_).exec(query);
     }
     template<typename... T>
@@ -73,6 +78,7 @@ public:
 
     //------- INSERT ----------
     [[nodiscard]] i64 insert(Query const& query) const {
+        std::lock_guard lock{mutex_};
         if (Stmt stmt(db_); stmt.exec(query))
             return sqlite3_last_insert_rowid(db_);;
         return INVALID_ROWID;
@@ -84,6 +90,7 @@ public:
 
     //------- UPDATE ----------
     [[nodiscard]] bool update(Query const& query) const {
+        std::lock_guard lock{mutex_};
         return Stmt(db_).exec(query);
     }
     template<typename... T>
@@ -93,6 +100,7 @@ public:
 
     //------- SELECT ----------
     [[nodiscard]] std::optional<Result> select(Query const& query) const {
+        std::lock_guard lock{mutex_};
         return Stmt(db_).exec_with_result(query);
     }
     template<typename... T>
@@ -100,6 +108,19 @@ public:
         return select(Query{query_str, args...});
     }
 
+    //------- TRANSACTION ----------
+    /// Run 'fn' inside one transaction (committed if 'fn' returns true,
+    /// rolled back otherwise). Other threads wait until it is finished.
+    bool transaction(std::function<bool()> const& fn) const {
+        std::lock_guard lock{mutex_};
+        if (!exec("BEGIN"))
+            return false;
+        if (fn())
+            return exec("COMMIT");
+        (void)exec("ROLLBACK");
+        return false;
+    }
+
 private:
     SQLite() {
         sqlite3_initialize();
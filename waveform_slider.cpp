@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2024 Piotr Pszczółkowski
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Piotr Pszczółkowski on 19.10.2026.
+// piotr@beesoft.pl
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "waveform_slider.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QStyleOptionSlider>
+
+WaveformSlider::WaveformSlider(QWidget* const parent) : QSlider(Qt::Horizontal, parent) {
+    setMinimumHeight(32);
+}
+
+void WaveformSlider::set_waveform(Waveform waveform) {
+    waveform_ = std::move(waveform);
+    update();
+}
+
+/// One vertical line per pixel column, from the min to the max of the points
+/// that fall into it. The groove and the handle are painted over it.
+void WaveformSlider::paintEvent(QPaintEvent* const event) {
+    if (!waveform_.empty()) {
+        QStyleOptionSlider option{};
+        initStyleOption(&option);
+        auto const groove = style()->subControlRect(QStyle::CC_Slider, &option, QStyle::SC_SliderGroove, this);
+        auto const left = groove.left();
+        auto const width = std::max(1, groove.width());
+        auto const middle = rect().center().y();
+        auto const half = rect().height() / 2 - 1;
+        auto const played = maximum() > minimum()
+            ? left + int(qint64(value() - minimum()) * width / (maximum() - minimum()))
+            : left;
+        auto const base = palette().color(QPalette::Mid);
+        auto const highlight = palette().color(QPalette::Highlight);
+
+        QPainter painter{this};
+        auto const points = waveform_.size();
+        for (auto x = 0; x < width; ++x) {
+            auto const first = size_t(x) * points / size_t(width);
+            auto const last = std::max(first + 1, size_t(x + 1) * points / size_t(width));
+            auto lo = waveform_.min(first);
+            auto hi = waveform_.max(first);
+            for (auto i = first + 1; i < last && i < points; ++i) {
+                lo = std::min(lo, waveform_.min(i));
+                hi = std::max(hi, waveform_.max(i));
+            }
+            painter.setPen(left + x < played ? highlight : base);
+            painter.drawLine(left + x, middle - int(hi * float(half)), left + x, middle - int(lo * float(half)));
+        }
+    }
+    QSlider::paintEvent(event);
+}